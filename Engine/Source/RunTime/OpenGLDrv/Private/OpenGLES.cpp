@@ -88,7 +88,35 @@ bool FOpenGLES::bSupportsShaderFramebufferFetch = false;
 bool FOpenGLES::bSupportsShaderDepthStencilFetch = false;
 
 /** GL_EXT_multisampled_render_to_texture */
-bool FOpenGLES::bSupportsMultisampledRenderToTexture = true;//CBR Code 改为返回true
+bool FOpenGLES::bSupportsMultisampledRenderToTexture = false;
+
+/** Sampleable 2x colour and depth textures created with glTexStorage2DMultisample (OpenGL ES 3.1) */
+bool FOpenGLES::bSupportsMultisampledTextures = false;
+
+/** GL_OES_sample_shading or OpenGL ES 3.2 */
+bool FOpenGLES::bSupportsSampleShading = false;
+
+/** Result of ProbeCheckerboardRendering */
+FOpenGLES::ECheckerboardSupport FOpenGLES::CheckerboardSupport = FOpenGLES::ECheckerboardSupport::None;
+
+/** GL_EXT_shader_pixel_local_storage, bytes per pixel or 0 if not available */
+GLint FOpenGLES::MaxPixelLocalStorageSize = 0;
+
+static TAutoConsoleVariable<int32> CVarCheckerboardSupport(
+	TEXT("r.OpenGL.CBRSupport"),
+	0,
+	TEXT("Mobile checkerboard rendering support detected on this device, written once when the GL extensions are processed.\n")
+	TEXT(" 0: None, CBR is disabled\n")
+	TEXT(" 1: Reduced, CBR reconstructs from the current frame only\n")
+	TEXT(" 2: Full"),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarPixelLocalStorageSize(
+	TEXT("r.OpenGL.PixelLocalStorageSize"),
+	0,
+	TEXT("Bytes of pixel local storage per pixel (GL_EXT_shader_pixel_local_storage) reported by this device, 0 if not available.\n")
+	TEXT("Written once when the GL extensions are processed, the mobile renderer uses it to keep CBR samples on tile."),
+	ECVF_RenderThreadSafe);
 
 /** GL_NV_texture_compression_s3tc, GL_EXT_texture_compression_s3tc */
 bool FOpenGLES::bSupportsDXT = false;
@@ -318,6 +346,101 @@ void FOpenGLES::ProcessExtensions(const FString& ExtensionsString)
 		glCopyImageSubDataEXT = (PFNGLCOPYIMAGESUBDATAEXTPROC)((void*)eglGetProcAddress("glCopyImageSubDataEXT"));
 	}
 	bSupportsCopyImage = (glCopyImageSubDataEXT != nullptr);
+
+	ProbeCheckerboardRendering(ExtensionsString);
+}
+
+void FOpenGLES::ProbeCheckerboardRendering(const FString& ExtensionsString)
+{
+	extern GLint GMaxOpenGLColorSamples;
+	extern GLint GMaxOpenGLDepthSamples;
+	extern GLint GMaxOpenGLIntegerSamples;
+
+	bSupportsSampleShading = IsES32Usable() || ExtensionsString.Contains(TEXT("GL_OES_sample_shading"));
+
+	GLint MaxSamples = 0;
+	glGetIntegerv(GL_MAX_SAMPLES, &MaxSamples);
+	glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &GMaxOpenGLColorSamples);
+	glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &GMaxOpenGLDepthSamples);
+	glGetIntegerv(GL_MAX_INTEGER_SAMPLES, &GMaxOpenGLIntegerSamples);
+	UE_LOG(LogRHI, Log, TEXT("Max samples: %d, color texture samples: %d, depth texture samples: %d"), MaxSamples, GMaxOpenGLColorSamples, GMaxOpenGLDepthSamples);
+
+	// CBR renders into sampleable 2x colour and depth/stencil textures, so the driver has to accept both
+	// in a complete framebuffer, not just advertise the sample counts
+	const GLsizei NumSamples = 2;
+	bSupportsMultisampledTextures = false;
+	bool bExpectedSamplePositions = false;
+	if (IsES31Usable() && FMath::Min3(MaxSamples, GMaxOpenGLColorSamples, GMaxOpenGLDepthSamples) >= NumSamples)
+	{
+		GLuint Textures[2] = { 0, 0 };
+		GLuint Framebuffer = 0;
+		glGenTextures(2, Textures);
+		glGenFramebuffers(1, &Framebuffer);
+
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, Textures[0]);
+		glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, NumSamples, GL_RGBA8, 4, 4, GL_TRUE);
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, Textures[1]);
+		glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, NumSamples, GL_DEPTH24_STENCIL8, 4, 4, GL_TRUE);
+
+		GLint bFixedSampleLocations = GL_FALSE;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D_MULTISAMPLE, 0, GL_TEXTURE_FIXED_SAMPLE_LOCATIONS, &bFixedSampleLocations);
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, Textures[0], 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, Textures[1], 0);
+		bSupportsMultisampledTextures = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE && glGetError() == GL_NO_ERROR;
+
+		if (bSupportsMultisampledTextures && bFixedSampleLocations)
+		{
+			// The reconstruct shader assumes the standard 2x pattern: the two samples sit on opposite corners of the pixel,
+			// a quarter pixel away from its centre on each axis, so that each sample lands on one full resolution pixel
+			GLfloat SamplePositions[2][2];
+			glGetMultisamplefv(GL_SAMPLE_POSITION, 0, SamplePositions[0]);
+			glGetMultisamplefv(GL_SAMPLE_POSITION, 1, SamplePositions[1]);
+
+			bExpectedSamplePositions = true;
+			for (int32 Axis = 0; Axis < 2; ++Axis)
+			{
+				const float Offset0 = SamplePositions[0][Axis] - 0.5f;
+				const float Offset1 = SamplePositions[1][Axis] - 0.5f;
+				bExpectedSamplePositions &= FMath::IsNearlyEqual(FMath::Abs(Offset0), 0.25f, 1.0f / 16.0f) && FMath::IsNearlyEqual(Offset0, -Offset1, 1.0f / 16.0f);
+			}
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &Framebuffer);
+		glDeleteTextures(2, Textures);
+	}
+
+	if (!bSupportsMultisampledTextures)
+	{
+		CheckerboardSupport = ECheckerboardSupport::None;
+	}
+	else if (!bSupportsSampleShading || !bExpectedSamplePositions)
+	{
+		CheckerboardSupport = ECheckerboardSupport::Reduced;
+	}
+	else
+	{
+		CheckerboardSupport = ECheckerboardSupport::Full;
+	}
+
+	static const TCHAR* CheckerboardSupportNames[] = { TEXT("None"), TEXT("Reduced"), TEXT("Full") };
+	UE_LOG(LogRHI, Log, TEXT("Checkerboard rendering support: %s (multisampled textures: %d, sample shading: %d, sample positions: %d)"),
+		CheckerboardSupportNames[(int32)CheckerboardSupport], bSupportsMultisampledTextures, bSupportsSampleShading, bExpectedSamplePositions);
+
+	CVarCheckerboardSupport->Set((int32)CheckerboardSupport, ECVF_SetByCode);
+
+	// Mali: pixel local storage tells us the tile keeps per pixel data between draws of the same pass,
+	// which is what the on-tile CBR configuration relies on
+	MaxPixelLocalStorageSize = 0;
+	if (CheckerboardSupport != ECheckerboardSupport::None && ExtensionsString.Contains(TEXT("GL_EXT_shader_pixel_local_storage")))
+	{
+		glGetIntegerv(GL_MAX_SHADER_PIXEL_LOCAL_STORAGE_SIZE_EXT, &MaxPixelLocalStorageSize);
+		UE_LOG(LogRHI, Log, TEXT("Pixel local storage: %d bytes per pixel"), MaxPixelLocalStorageSize);
+	}
+	CVarPixelLocalStorageSize->Set((int32)MaxPixelLocalStorageSize, ECVF_SetByCode);
 }
 
 #endif
@@ -84,9 +84,9 @@ class FOpenGLDynamicRHI* FOpenGLTextureBase::OpenGLRHI = nullptr;
 -----------------------------------------------------------------------------*/
 
 /** Caching it here, to avoid getting it every time we create a texture. 0 is no multisampling. */
-GLint GMaxOpenGLColorSamples = 2;//CBR Code set to 2 but default 0
-GLint GMaxOpenGLDepthSamples = 2;
-GLint GMaxOpenGLIntegerSamples = 2;
+GLint GMaxOpenGLColorSamples = 0;
+GLint GMaxOpenGLDepthSamples = 0;
+GLint GMaxOpenGLIntegerSamples = 0;
 
 // in bytes, never change after RHI, needed to scale game features
 int64 GOpenGLDedicatedVideoMemory = 0;
@@ -369,11 +369,18 @@ FRHITexture* FOpenGLDynamicRHI::CreateOpenGLRHITextureOnly(const uint32 SizeX, c
 	uint32 NumSamplesTileMem = 1;
 	GLint MaxSamplesTileMem = FOpenGL::GetMaxMSAASamplesTileMem(); /* RHIs which do not support tiled GPU MSAA return 0 */
 	
-	if (MaxSamplesTileMem > 0 && CVarTileMem.GetValueOnRenderThread())//CBR Code 不使用TileMem
+	//CBR Code 不使用TileMem, 除非设备不支持可采样的MSAA纹理
+	//Memoryless的MSAA深度(CBR compact depth history)不会被采样, 可以留在TileMem里
+	const bool bTileMemDepth = (Flags & TexCreate_DepthStencilTargetable) && (Flags & TexCreate_Memoryless) && NumSamples > 1 && MaxSamplesTileMem >= (GLint)NumSamples;
+	if (MaxSamplesTileMem > 0 && (CVarTileMem.GetValueOnRenderThread() || !FOpenGL::SupportsMultisampledTextures() || bTileMemDepth))
 	{
 		NumSamplesTileMem = FMath::Min<uint32>(NumSamples, MaxSamplesTileMem);
 		NumSamples = 1;
 	}
+	else if (!FOpenGL::SupportsMultisampledTextures())
+	{
+		NumSamples = 1;
+	}
 
 	GLenum Target = GL_NONE;
 	if (bCubeTexture)
@@ -698,7 +705,7 @@ void FOpenGLDynamicRHI::InitializeGLTextureInternal(GLuint TextureID, FRHITextur
 			BulkData->Discard();
 		}
 	}
-	else if (TileMemDepth)//CBR Hint 不使用TileMemDepth
+	else if (TileMemDepth)//CBR Hint 只有Memoryless的深度才使用TileMemDepth
 	{
 #if PLATFORM_ANDROID && !PLATFORM_LUMINGL4		
 		Target = GL_RENDERBUFFER;
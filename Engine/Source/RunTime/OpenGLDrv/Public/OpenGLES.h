@@ -73,6 +73,10 @@ typedef GLfloat GLdouble;
 #ifndef GL_TEXTURE_LOD_BIAS
 #define GL_TEXTURE_LOD_BIAS 0x8501
 #endif
+#ifndef GL_MAX_SHADER_PIXEL_LOCAL_STORAGE_SIZE_EXT
+/* GL_EXT_shader_pixel_local_storage */
+#define GL_MAX_SHADER_PIXEL_LOCAL_STORAGE_SIZE_EXT 0x8F63
+#endif
 #ifndef GL_FRAMEBUFFER_SRGB
 #define GL_FRAMEBUFFER_SRGB 0x8DB9
 #endif
@@ -163,6 +167,14 @@ using namespace GLFuncPointers;
 
 struct FOpenGLES : public FOpenGLBase
 {
+	/** How much of the mobile checkerboard rendering path this device can run, see ProbeCheckerboardRendering */
+	enum class ECheckerboardSupport : uint8
+	{
+		None,		// no sampleable 2x MSAA targets
+		Reduced,	// sampleable 2x MSAA targets, but no per-sample shading or unexpected sample positions
+		Full
+	};
+
 	static FORCEINLINE bool IsES31Usable()
 	{
 		check(CurrentFeatureLevelSupport != EFeatureLevelSupport::Invalid);
@@ -177,6 +189,7 @@ struct FOpenGLES : public FOpenGLBase
 
 	static void		ProcessQueryGLInt();
 	static void		ProcessExtensions(const FString& ExtensionsString);
+	static void		ProbeCheckerboardRendering(const FString& ExtensionsString);
 
 	static FORCEINLINE bool SupportsUniformBuffers() { return true; }
 	static FORCEINLINE bool SupportsStructuredBuffers() { return true; }
@@ -188,7 +201,7 @@ struct FOpenGLES : public FOpenGLBase
 	static FORCEINLINE bool SupportsDepthStencilRead() { return false; }
 	static FORCEINLINE bool SupportsFloatReadSurface() { return SupportsColorBufferHalfFloat(); }
 	static FORCEINLINE bool SupportsWideMRT() { return true; }
-	static FORCEINLINE bool SupportsMultisampledTextures() { return true; }//CBR Code 改为返回true
+	static FORCEINLINE bool SupportsMultisampledTextures() { return bSupportsMultisampledTextures; }
 	static FORCEINLINE bool SupportsPolygonMode() { return false; }
 	static FORCEINLINE bool SupportsTexture3D() { return true; }
 	static FORCEINLINE bool SupportsMobileMultiView() { return bSupportsMobileMultiView; }
@@ -204,6 +217,10 @@ struct FOpenGLES : public FOpenGLBase
 	static FORCEINLINE bool SupportsShaderFramebufferFetch() { return bSupportsShaderFramebufferFetch; }
 	static FORCEINLINE bool SupportsShaderDepthStencilFetch() { return bSupportsShaderDepthStencilFetch; }
 	static FORCEINLINE bool SupportsMultisampledRenderToTexture() { return bSupportsMultisampledRenderToTexture; }
+	static FORCEINLINE bool SupportsSampleShading() { return bSupportsSampleShading; }
+	static FORCEINLINE ECheckerboardSupport GetCheckerboardSupport() { return CheckerboardSupport; }
+	static FORCEINLINE bool SupportsPixelLocalStorage() { return MaxPixelLocalStorageSize > 0; }
+	static FORCEINLINE GLint GetMaxPixelLocalStorageSize() { return MaxPixelLocalStorageSize; }
 	static FORCEINLINE bool SupportsVertexArrayBGRA() { return false; }
 	static FORCEINLINE bool SupportsBGRA8888() { return bSupportsBGRA8888; }
 	static FORCEINLINE bool SupportsDXT() { return bSupportsDXT; }
@@ -687,6 +704,11 @@ struct FOpenGLES : public FOpenGLBase
 		glVertexAttribDivisor(Index, Divisor);
 	}
 
+	static FORCEINLINE bool TexStorage2DMultisample(GLenum Target, GLsizei Samples, GLint InternalFormat, GLsizei Width, GLsizei Height, GLboolean FixedSampleLocations)
+	{
+		glTexStorage2DMultisample(Target, Samples, InternalFormat, Width, Height, FixedSampleLocations);
+		return true;
+	}
 	static FORCEINLINE void TexStorage3D(GLenum Target, GLint Levels, GLint InternalFormat, GLsizei Width, GLsizei Height, GLsizei Depth, GLenum Format, GLenum Type)
 	{
 		glTexStorage3D(Target, Levels, InternalFormat, Width, Height, Depth);
@@ -789,6 +811,18 @@ protected:
 	/** GL_EXT_MULTISAMPLED_RENDER_TO_TEXTURE */
 	static bool bSupportsMultisampledRenderToTexture;
 
+	/** Sampleable 2x colour and depth textures created with glTexStorage2DMultisample (OpenGL ES 3.1) */
+	static bool bSupportsMultisampledTextures;
+
+	/** GL_OES_sample_shading or OpenGL ES 3.2 */
+	static bool bSupportsSampleShading;
+
+	/** Result of ProbeCheckerboardRendering */
+	static ECheckerboardSupport CheckerboardSupport;
+
+	/** GL_EXT_shader_pixel_local_storage, bytes per pixel or 0 if not available */
+	static GLint MaxPixelLocalStorageSize;
+
 	/** GL_FRAGMENT_SHADER, GL_LOW_FLOAT */
 	static int ShaderLowPrecision;
 
@@ -56,6 +56,7 @@
 #include "PlanarReflectionSceneProxy.h"
 #include "SceneOcclusion.h"
 #include "VariableRateShadingImageManager.h"
+#include "PixelShaderUtils.h"
 
 uint32 GetShadowQuality();
 
@@ -64,7 +65,150 @@ static TAutoConsoleVariable<int32> CVarMobileCBR(
 	1,
 	TEXT("CBR for mobile platform.\n")
 	TEXT(" 0: Disable\n")
-	TEXT(" 1: Enabled (Default)"),
+	TEXT(" 1: Enabled (Default)\n")
+	TEXT(" 2: Quarter rate, each frame shades one of four pixels and reconstructs from three frames of history\n")
+	TEXT("Pixel projected reflection turns MSAA off, so it only runs at checkerboard rate with 2; otherwise it stays full resolution.\n")
+	TEXT("Views with the full depth prepass are always rendered at full resolution."),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRCompactDepthHistory(
+	TEXT("r.Mobile.CBR.CompactDepthHistory"),
+	0,
+	TEXT("Keep CBR depth/stencil in tile memory and store only per-sample scene depth (R16F) for reconstruction.\n")
+	TEXT("Requires depth fetch (GSupportsShaderDepthStencilFetch) and a single scene colour render pass.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSplitSamples(
+	TEXT("r.Mobile.CBR.SplitSamples"),
+	0,
+	TEXT("At the end of the CBR scene pass, split the colour samples into a plain texture through framebuffer fetch,\n")
+	TEXT("so the MSAA colour target is not stored and reconstruction avoids Texture2DMS loads.\n")
+	TEXT("Requires framebuffer fetch and pixel shader UAVs.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRReconstructPS(
+	TEXT("r.Mobile.CBR.ReconstructPS"),
+	0,
+	TEXT("Run CBR reconstruction as a fullscreen pixel shader that writes the full resolution scene colour directly,\n")
+	TEXT("instead of a compute dispatch followed by a copy. Preferable on tile based GPUs.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBROnTilePreset(
+	TEXT("r.Mobile.CBR.OnTilePreset"),
+	0,
+	TEXT("Preset for tile based GPUs that report pixel local storage (r.OpenGL.PixelLocalStorageSize > 0, Mali).\n")
+	TEXT("Turns on CompactDepthHistory, SplitSamples and ReconstructPS where the device supports them, so the multisampled\n")
+	TEXT("colour and depth targets are never stored and only the compact colour and depth history is written for the next frame.\n")
+	TEXT("Pixel local storage itself is not used.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSpatialUpscale(
+	TEXT("r.Mobile.CBR.SpatialUpscale"),
+	0,
+	TEXT("With a screen percentage below 100 in the LDR path, upscale the reconstructed CBR image to the output\n")
+	TEXT("with an edge adaptive (EASU style) filter instead of the post processing upscale.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+// Some passes the CBR paths depend on set their viewport from View.ViewRect in code outside this tree, so they would draw
+// full size into the half size CBR targets. Each path below stays off until those passes place their viewport with
+// CBRData::SetViewport.
+// RenderVelocities: r.Mobile.CBR.Velocity is ignored
+#define CBR_VELOCITY_PASS_USES_CBR_VIEWPORT 0
+// RenderMobileBasePass, RenderDecals and MobileDeferredShadingPass: r.Mobile.CBR.Deferred is ignored
+#define CBR_DEFERRED_PASSES_USE_CBR_VIEWPORT 0
+// RenderPrePass: views with the full depth prepass render at full resolution
+#define CBR_PREPASS_USES_CBR_VIEWPORT 0
+
+static TAutoConsoleVariable<int32> CVarMobileCBRVelocity(
+	TEXT("r.Mobile.CBR.Velocity"),
+	0,
+	TEXT("Render the velocity of movable primitives into a CBR sized target after the scene pass,\n")
+	TEXT("so reconstruction follows moving and skinned objects instead of treating them as missing pixels.\n")
+	TEXT("Ignored until the velocity pass uses the CBR viewport (CBR_VELOCITY_PASS_USES_CBR_VIEWPORT).\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRHistoryValidation(
+	TEXT("r.Mobile.CBR.HistoryValidation"),
+	1,
+	TEXT("How CBR reconstruction decides whether a reprojected history sample of a moving pixel can be used.\n")
+	TEXT(" 0: Never, moving pixels are interpolated from the current frame\n")
+	TEXT(" 1: Compare the history depth with the current frame depth around it (Default)\n")
+	TEXT(" 2: Always use it, clamped to the YCoCg variance box of the current frame neighbours"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSecondHistory(
+	TEXT("r.Mobile.CBR.SecondHistory"),
+	0,
+	TEXT("Keep the CBR targets of frame N-2, which shaded the same checkerboard quadrants as the current frame,\n")
+	TEXT("and try them before interpolating pixels whose N-1 position was not shaded. Costs one more colour and depth target.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled, within r.Mobile.CBR.SecondHistoryBudgetMB"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSecondHistoryBudgetMB(
+	TEXT("r.Mobile.CBR.SecondHistoryBudgetMB"),
+	24,
+	TEXT("Largest amount of memory in MB the N-2 colour and depth targets of r.Mobile.CBR.SecondHistory may use,\n")
+	TEXT("above it (large resolutions) the second history is not allocated."),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarMobileCBRSkyDistance(
+	TEXT("r.Mobile.CBR.SkyDistance"),
+	1000000.0f,
+	TEXT("Pixels of the CBR scene further than this (in world units) are treated as sky: reconstruction reprojects them\n")
+	TEXT("with the camera rotation only and skips the occlusion depth test. 0 disables the sky path."),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSeparateTranslucency(
+	TEXT("r.Mobile.CBR.SeparateTranslucency"),
+	0,
+	TEXT("Render translucency after CBR reconstruction into its own single sample target, depth tested against\n")
+	TEXT("the current frame's CBR depth, then upsample and composite it over the reconstructed scene colour.\n")
+	TEXT(" 0: Disable, translucency is checkerboarded with the scene (Default)\n")
+	TEXT(" 1: Half resolution\n")
+	TEXT(" 2: Quarter resolution"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRDeferred(
+	TEXT("r.Mobile.CBR.Deferred"),
+	0,
+	TEXT("CBR for the mobile deferred shading path. The GBuffer is read per pixel by the shading subpass, so this always\n")
+	TEXT("runs quarter rate: GBuffer, lighting and translucency are rendered into single sample half resolution targets.\n")
+	TEXT("Requires r.Mobile.CBR and no full depth prepass.\n")
+	TEXT("Ignored until the deferred passes use the CBR viewport (CBR_DEFERRED_PASSES_USE_CBR_VIEWPORT).\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRSceneCaptures(
+	TEXT("r.Mobile.CBR.SceneCaptures"),
+	0,
+	TEXT("Render scene captures and planar reflections at checkerboard rate, each with its own phase and history.\n")
+	TEXT("Captures without a view state (one-shot captures) reconstruct from the current frame only.\n")
+	TEXT(" 0: Disable, they render at full resolution (Default)\n")
+	TEXT(" 1: Enabled"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarMobileCBRFrameInterpolation(
+	TEXT("r.Mobile.CBR.FrameInterpolation"),
+	0,
+	TEXT("Experimental. Synthesise the frame half way between the previous and the current reconstructed frame\n")
+	TEXT("by reprojecting with the CBR depth, for camera motion only. The result is kept in CBRInterpolatedOutput.\n")
+	TEXT(" 0: Disable (Default)\n")
+	TEXT(" 1: Enabled\n")
+	TEXT(" 2: Enabled, and show the interpolated frame instead of the current one"),
 	ECVF_RenderThreadSafe);
 
 static TAutoConsoleVariable<int32> CVarMobileCBRRenderMotionVectors(
@@ -833,7 +977,24 @@ void FMobileSceneRenderer::Render(FRHICommandListImmediate& RHICmdList)
 		GraphBuilder.Execute();
 	}
 
-	if (bIsFullPrepassEnabled)
+	//CBR要在full prepass之前决定: 开启时prepass在RenderForward分配CBR target之后直接画进本帧相位的深度
+	bool bCBRFullPrepass = false;
+	//CBR关闭时历史全部释放, 否则每帧释放不再画CBR的view的历史, 不管这个view本帧是否开启CBR
+	if (CVarMobileCBR.GetValueOnRenderThread() == 0)
+	{
+		CBRData::ReleaseHistories();
+	}
+	else
+	{
+		CBRData::ReleaseStaleHistories();
+	}
+	if (!bDeferredShading)
+	{
+		CBRInitForward(Views[0]);
+		bCBRFullPrepass = bIsFullPrepassEnabled && CBRData::bCBR;
+	}
+
+	if (bIsFullPrepassEnabled && !bCBRFullPrepass)
 	{
 		//SDF and AO require full depth prepass
 
@@ -1018,12 +1179,21 @@ void FMobileSceneRenderer::Render(FRHICommandListImmediate& RHICmdList)
 				FMobilePostProcessingInputs PostProcessingInputs;
 				PostProcessingInputs.ViewFamilyTexture = ViewFamilyTexture;
 
-				for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+				//CBR Code
+				if (ViewFamilyTexture && ShouldCBRSpatialUpscale())
+				{
+					CBRSpatialUpscalePass(GraphBuilder, Views[0], GraphBuilder.RegisterExternalTexture(SceneContext.GetSceneColor()), ViewFamilyTexture);
+				}
+				else
 				{
-					RDG_EVENT_SCOPE_CONDITIONAL(GraphBuilder, Views.Num() > 1, "View%d", ViewIndex);
-					PostProcessingInputs.SceneTextures = MobileSceneTexturesPerView[ViewIndex];
-					AddMobilePostProcessingPasses(GraphBuilder, Views[ViewIndex], PostProcessingInputs, NumMSAASamples > 1);
+					for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+					{
+						RDG_EVENT_SCOPE_CONDITIONAL(GraphBuilder, Views.Num() > 1, "View%d", ViewIndex);
+						PostProcessingInputs.SceneTextures = MobileSceneTexturesPerView[ViewIndex];
+						AddMobilePostProcessingPasses(GraphBuilder, Views[ViewIndex], PostProcessingInputs, NumMSAASamples > 1);
+					}
 				}
+				//
 			}
 		}
 	}
@@ -1051,19 +1221,231 @@ void FMobileSceneRenderer::Render(FRHICommandListImmediate& RHICmdList)
 }
 
 //CBR code
-bool CBRData::bCBR = true;
+bool CBRData::bCBR = false;
 FVector2D CBRData::mDownsizeFactor = FVector2D(1.f);
 uint32 CBRData::FrameCount = 0;
 int32 CBRData::mFrameOffset = 0;
+bool CBRData::bSpatialOnly = false;
+bool CBRData::bQuarterRate = false;
+const int32 CBRData::QuarterRateQuadrants[4] = { 0, 3, 1, 2 };
+FVector2D CBRData::mViewportOffset = FVector2D::ZeroVector;
+TMap<uint32, CBRData::FViewHistory> CBRData::ViewHistories;
+
+// Histories of views that stopped rendering are released after this many frames
+static const uint32 CBRViewHistoryMaxAge = 60;
+
+// The history targets are pooled render targets, so they must be released with the other RHI resources
+class FCBRViewHistoryResource : public FRenderResource
+{
+public:
+	virtual void ReleaseDynamicRHI() override
+	{
+		CBRData::ReleaseHistories();
+	}
+};
+static TGlobalResource<FCBRViewHistoryResource> GCBRViewHistoryResource;
+
+void CBRData::FViewHistory::FindTarget(FRHICommandList& RHICmdList, const FPooledRenderTargetDesc& Desc, TRefCountPtr<IPooledRenderTarget>& Out, const TCHAR* Name)
+{
+	if (Targets.Num() <= NextTarget)
+	{
+		Targets.AddDefaulted();
+	}
+	//desc没变时FindFreeElement直接返回传入的target
+	TRefCountPtr<IPooledRenderTarget>& Target = Targets[NextTarget++];
+	GRenderTargetPool.FindFreeElement(RHICmdList, Desc, Target, Name);
+	Out = Target;
+}
+
+void CBRData::FViewHistory::ResetMatrices(const FMatrix& InvViewProj)
+{
+	PrevInvViewProj = InvViewProj;
+	PrevPrevInvViewProj = InvViewProj;
+	RightEyePrevInvViewProj = InvViewProj;
+	for (int32 Slot = 0; Slot < 4; ++Slot)
+	{
+		HistoryInvViewProj[Slot] = InvViewProj;
+	}
+	bHasInterpolateViewMatrices = false;
+}
+
+void CBRData::ReleaseStaleHistories()
+{
+	//很久没画的view释放它的历史target
+	for (auto It = ViewHistories.CreateIterator(); It; ++It)
+	{
+		if (GFrameNumberRenderThread - It.Value().LastFrameNumber > CBRViewHistoryMaxAge)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void CBRData::ReleaseHistories()
+{
+	ViewHistories.Empty();
+}
+
+CBRData::FViewHistory* CBRData::BeginView(const FViewInfo& View, bool& bOutHistoryValid)
+{
+	bOutHistoryValid = false;
+	if (!View.ViewState)
+	{
+		return nullptr;
+	}
+
+	FViewHistory* History = ViewHistories.Find(View.ViewState->UniqueID);
+	if (!History)
+	{
+		History = &ViewHistories.Add(View.ViewState->UniqueID);
+		History->LastFrameNumber = GFrameNumberRenderThread;
+	}
+	//上一帧没画(新view, 间隔渲染的capture): 从头开始一个周期
+	if (History->FrameCount == 0 || GFrameNumberRenderThread - History->LastFrameNumber > 1)
+	{
+		History->FrameCount = 0;
+		History->ResetMatrices(View.ViewMatrices.GetInvViewProjectionMatrix());
+	}
+	//Quarter rate要前三帧的slot都画过
+	bOutHistoryValid = History->FrameCount >= uint32(bQuarterRate ? 3 : 1);
+	History->LastFrameNumber = GFrameNumberRenderThread;
+	History->NextTarget = 0;
+	return History;
+}
+
+void CBRData::AdvanceFrame(FViewHistory* History)
+{
+	if (History)
+	{
+		FrameCount = History->FrameCount;
+	}
+	mFrameOffset = FrameCount % (bQuarterRate ? 4 : 2);
+	++FrameCount;
+	if (History)
+	{
+		History->FrameCount = FrameCount;
+	}
+	if (bQuarterRate)
+	{
+		//移动的是几何而不是像素中心: 视口偏移d让像素采样到center - d, 所以往反方向移, 本帧slot的texel t才落在全分辨率像素2t + quadrantOffset上
+		const int32 Quadrant = QuarterRateQuadrants[mFrameOffset];
+		mViewportOffset = FVector2D(.25f - (Quadrant & 1) * .5f, .25f - (Quadrant >> 1) * .5f);
+	}
+	else
+	{
+		mViewportOffset = FVector2D(mFrameOffset * .5f, 0.f);
+	}
+}
+
+void CBRData::SetFullResolution()
+{
+	bCBR = false;
+	mDownsizeFactor = FVector2D(1.f, 1.f);
+	mViewportOffset = FVector2D::ZeroVector;
+}
+
+bool CBRData::SupportsPlatform(EShaderPlatform Platform)
+{
+	return IsAndroidOpenGLESPlatform(Platform) || IsVulkanMobilePlatform(Platform);
+}
+
+void CBRData::SetViewport(FRHICommandList& RHICmdList, const FIntRect& ViewRect)
+{
+	SetViewport(RHICmdList, ViewRect, mDownsizeFactor, bCBR ? mViewportOffset : FVector2D::ZeroVector);
+}
+
+void CBRData::SetViewport(FRHICommandList& RHICmdList, const FIntRect& ViewRect, const FVector2D& DownsizeFactor, const FVector2D& ViewportOffset)
+{
+	RHICmdList.SetViewport(ViewRect.Min.X / DownsizeFactor.X + ViewportOffset.X
+		, ViewRect.Min.Y / DownsizeFactor.Y + ViewportOffset.Y
+		, 0
+		, ViewRect.Max.X / DownsizeFactor.X + ViewportOffset.X
+		, ViewRect.Max.Y / DownsizeFactor.Y + ViewportOffset.Y
+		, 1);
+}
+
+// The reconstructed image replaces the resolved scene colour
+static void CopyCBROutput(FRHICommandListImmediate& RHICmdList, FRHITexture* Reconstructed, FRHITexture* SceneColorTarget)
+{
+	FRHITransitionInfo CopyTransitions[] = {
+		FRHITransitionInfo(Reconstructed, ERHIAccess::Unknown, ERHIAccess::CopySrc),
+		FRHITransitionInfo(SceneColorTarget, ERHIAccess::Unknown, ERHIAccess::CopyDest)
+	};
+	RHICmdList.Transition(MakeArrayView(CopyTransitions, UE_ARRAY_COUNT(CopyTransitions)));
+
+	FRHICopyTextureInfo CopyInfo;
+	CopyInfo.Size = FIntVector(
+		FMath::Min(Reconstructed->GetSizeXYZ().X, SceneColorTarget->GetSizeXYZ().X),
+		FMath::Min(Reconstructed->GetSizeXYZ().Y, SceneColorTarget->GetSizeXYZ().Y),
+		1);
+	// Multiview: one slice per eye
+	CopyInfo.NumSlices = FMath::Min(Reconstructed->GetSizeXYZ().Z, SceneColorTarget->GetSizeXYZ().Z);
+	RHICmdList.CopyTexture(Reconstructed, SceneColorTarget, CopyInfo);
+	RHICmdList.Transition(FRHITransitionInfo(SceneColorTarget, ERHIAccess::CopyDest, ERHIAccess::SRVMask));
+}
+
+// CBR targets are sampled by the reconstruct pass, so unlike the regular mobile MSAA surfaces they
+// must be real 2x MSAA images that are stored to memory and are never memoryless.
+static FPooledRenderTargetDesc GetCBRTargetDesc(const FPooledRenderTargetDesc& SceneDesc)
+{
+	FPooledRenderTargetDesc Desc = SceneDesc;
+	Desc.Extent /= 2;
+	Desc.NumSamples = 2;
+	Desc.Flags &= ~TexCreate_Memoryless;
+	Desc.TargetableFlags &= ~TexCreate_Memoryless;
+	Desc.TargetableFlags |= TexCreate_ShaderResource;
+	Desc.bForceSeparateTargetAndShaderResource = false;
+	return Desc;
+}
+
+// Targets the reconstruction reads back in a later frame come from the view's history when it has one
+static void FindCBRHistoryTarget(FRHICommandList& RHICmdList, CBRData::FViewHistory* History, const FPooledRenderTargetDesc& Desc, TRefCountPtr<IPooledRenderTarget>& Out, const TCHAR* Name)
+{
+	if (History)
+	{
+		History->FindTarget(RHICmdList, Desc, Out, Name);
+	}
+	else
+	{
+		GRenderTargetPool.FindFreeElement(RHICmdList, Desc, Out, Name);
+	}
+}
 
 IMPLEMENT_GLOBAL_SHADER_PARAMETER_STRUCT(FCBRUniformBuffer, "CBRUniformBuffer");
 
 IMPLEMENT_GLOBAL_SHADER_PARAMETER_STRUCT(FCBRUniformBufferDepth, "CBRUniformBufferDepth");
 //
 
+void FMobileSceneRenderer::CBRInitForward(const FViewInfo& View)
+{
+	// The GL RHI probes the device once and reports 0: no CBR, 1: reduced (spatial only), 2: full. Other RHIs are always full.
+	static const auto CVarRHICBRSupport = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.OpenGL.CBRSupport"));
+	const int32 RHICBRSupport = (IsOpenGLPlatform(ShaderPlatform) && CVarRHICBRSupport) ? CVarRHICBRSupport->GetValueOnRenderThread() : 2;
+	// Quarter rate renders into single sample targets, so it needs neither MSAA nor the GL checkerboard probe
+	CBRData::bQuarterRate = CVarMobileCBR.GetValueOnRenderThread() == 2;
+	CBRData::bCBR = CVarMobileCBR.GetValueOnRenderThread()!=0 && CBRData::SupportsPlatform(ShaderPlatform)
+		&& (CBRData::bQuarterRate || (NumMSAASamples > 1 && RHICBRSupport > 0));
+	CBRData::bSpatialOnly = !CBRData::bQuarterRate && RHICBRSupport == 1;
+	//Multiview: CBR target是每只眼一层的数组, quarter rate的四个slot还不支持数组
+	if (View.bIsMobileMultiViewEnabled && CBRData::bQuarterRate)
+	{
+		CBRData::bCBR = false;
+	}
+	//Scene capture和planar reflection需要单独开启, reflection capture总是全分辨率
+	if (View.bIsReflectionCapture || ((View.bIsSceneCapture || View.bIsPlanarReflection) && CVarMobileCBRSceneCaptures.GetValueOnRenderThread() == 0))
+	{
+		CBRData::bCBR = false;
+	}
+	//Full prepass画进CBR深度: SDF阴影和AO要读全分辨率深度(HZB只给AO用, 一起排除).
+	//Full prepass会让SupportsMSAA返回false, 所以这里只有quarter rate能开启
+	if (bIsFullPrepassEnabled && (!CBR_PREPASS_USES_CBR_VIEWPORT || bRequiresDistanceFieldShadowingPass || bRequiresAmbientOcclusionPass))
+	{
+		CBRData::bCBR = false;
+	}
+}
+
 FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> ViewList)
 {
-	CBRData::bCBR = CVarMobileCBR.GetValueOnRenderThread()!=0 && NumMSAASamples > 1;
 	const FViewInfo& View = *ViewList[0];
 	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
 
@@ -1152,52 +1534,194 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 	//生成RenderTarget和UniformBuffer
 	FRHITexture* CBRSceneColor = nullptr;
 	FRHITexture* CBRSceneDepth = nullptr;
+	FRHITexture* CBRDepthHistory = nullptr;
+	//每个view有自己的相位和历史, 没有历史时只做空间重建
+	bool bCBRHistoryValid = false;
+	CBRViewHistory = CBRData::bCBR ? CBRData::BeginView(View, bCBRHistoryValid) : nullptr;
+	CBRData::bSpatialOnly |= CBRData::bCBR && !bCBRHistoryValid;
+	// The on-tile options below all work on the 2x MSAA targets, quarter rate has none of them
+	const bool bCBR2x = CBRData::bCBR && !CBRData::bQuarterRate;
+	// Multiview reconstructs both eyes in one dispatch from the plain 2x MSAA arrays, none of the options below support arrays
+	const bool bCBRMultiView = bCBR2x && View.bIsMobileMultiViewEnabled;
+	// Pixel local storage only exists on GL, there it selects every on-tile option below
+	static const auto CVarRHIPixelLocalStorageSize = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.OpenGL.PixelLocalStorageSize"));
+	const bool bCBROnTile = bCBR2x && !bCBRMultiView && CVarMobileCBROnTilePreset.GetValueOnRenderThread() != 0
+		&& IsOpenGLPlatform(ShaderPlatform) && CVarRHIPixelLocalStorageSize && CVarRHIPixelLocalStorageSize->GetValueOnRenderThread() > 0;
+	// Depth fetch has to happen in the scene colour pass, so this only works when that pass is never split
+	const bool bCBRCompactDepth = bCBR2x && !bCBRMultiView && (bCBROnTile || CVarMobileCBRCompactDepthHistory.GetValueOnRenderThread() != 0) && GSupportsShaderDepthStencilFetch
+		&& !bRequiresMultiPass && !bRequiresPixelProjectedPlanarRelfectionPass;
+	const bool bCBRSplitSamples = bCBR2x && !bCBRMultiView && (bCBROnTile || CVarMobileCBRSplitSamples.GetValueOnRenderThread() != 0) && GSupportsShaderFramebufferFetch && GRHISupportsPixelShaderUAVs;
+	FRHITexture* CBRSplitColor = nullptr;
+	FRHIUnorderedAccessView* CBRSplitColorUAV = nullptr;
+	const bool bCBRReconstructPS = bCBR2x && !bCBRMultiView && (bCBROnTile || CVarMobileCBRReconstructPS.GetValueOnRenderThread() != 0);
+	// The velocity pass depth tests against the stored CBR depth, and only the compute reconstruct reads it
+	const bool bCBRVelocity = CBR_VELOCITY_PASS_USES_CBR_VIEWPORT && bCBR2x && !bCBRMultiView && CVarMobileCBRVelocity.GetValueOnRenderThread() != 0 && !bCBRCompactDepth && !bCBRReconstructPS;
+	// N-2 only replaces the plain MSAA colour and depth targets
+	bool bCBRSecondHistory = bCBR2x && !bCBRMultiView && CVarMobileCBRSecondHistory.GetValueOnRenderThread() != 0 && !bCBRCompactDepth && !bCBRSplitSamples && !bCBRReconstructPS;
+	// Full resolution divided by this on each axis, 0 when translucency stays in the CBR scene pass
+	const int32 CBRSeparateTranslucency = (bCBR2x && !bCBRMultiView && !bCBRCompactDepth) ? FMath::Clamp(CVarMobileCBRSeparateTranslucency.GetValueOnRenderThread(), 0, 2) : 0;
+	const int32 CBRTranslucencyFactor = CBRSeparateTranslucency > 0 ? (2 << (CBRSeparateTranslucency - 1)) : 0;
+	// Needs both reconstructed frames and device z for every sample
+	const int32 CBRFrameInterpolation = (bCBR2x && !bCBRMultiView && !bCBRReconstructPS && !bCBRCompactDepth) ? CVarMobileCBRFrameInterpolation.GetValueOnRenderThread() : 0;
 	if (CBRData::bCBR) {
 		CBRUniformBufferRHI = TUniformBufferRef<FCBRUniformBuffer>::CreateUniformBufferImmediate(CBRUniformBuffer, EUniformBufferUsage::UniformBuffer_SingleFrame);
 		CBRUniformBufferDepthRHI = TUniformBufferRef<FCBRUniformBufferDepth>::CreateUniformBufferImmediate(CBRUniformBufferDepth, EUniformBufferUsage::UniformBuffer_SingleFrame);
 		{
-			FPooledRenderTargetDesc DescD = SceneContext.SceneDepthZ->GetDesc();
-			FPooledRenderTargetDesc DescC = SceneContext.GetSceneColor()->GetDesc();
-			FPooledRenderTargetDesc DescO = SceneContext.GetSceneColor()->GetDesc();
-			FPooledRenderTargetDesc DescOD = SceneContext.SceneDepthZ->GetDesc();
-			DescD.Extent /= 2;
-			DescC.Extent /= 2;
-			if (!CBRSceneColorRef1.GetReference()) {
-				GRenderTargetPool.FindFreeElement(RHICmdList, DescC, CBRSceneColorRef1, TEXT("CBRSeneColor"));
-			}
-			if (!CBRSceneDepthRef1.GetReference()) {
-				GRenderTargetPool.FindFreeElement(RHICmdList, DescD, CBRSceneDepthRef1, TEXT("CBRSceneDepth"));
+			const FPooledRenderTargetDesc DescD = GetCBRTargetDesc(SceneContext.SceneDepthZ->GetDesc());
+			const FPooledRenderTargetDesc DescC = GetCBRTargetDesc(SceneContext.GetSceneColor()->GetDesc());
+			FPooledRenderTargetDesc DescO = FPooledRenderTargetDesc::Create2DDesc(SceneContext.GetBufferSizeXY(), SceneContext.GetSceneColor()->GetDesc().Format, FClearValueBinding::Black, TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false);
+			FPooledRenderTargetDesc DescOD = FPooledRenderTargetDesc::Create2DDesc(SceneContext.GetBufferSizeXY(), PF_R32_FLOAT, FClearValueBinding::Black, TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false);
+			//DescC/DescD从SceneColor继承了数组层数, 输出也要每只眼一层
+			if (bCBRMultiView)
+			{
+				DescO.ArraySize = 2;
+				DescO.bIsArray = true;
 			}
 
-			if (!CBRSceneColorRef0.GetReference()) {
-				GRenderTargetPool.FindFreeElement(RHICmdList, DescC, CBRSceneColorRef0, TEXT("CBRSeneColorPrev"));
+			if (CBRData::bQuarterRate)
+			{
+				//每帧只着色2x2中的一个像素, 单sample
+				FPooledRenderTargetDesc DescQC = DescC;
+				FPooledRenderTargetDesc DescQD = DescD;
+				DescQC.NumSamples = 1;
+				DescQD.NumSamples = 1;
+				for (int32 Slot = 0; Slot < 4; ++Slot)
+				{
+					FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescQC, CBRQuarterColorRefs[Slot], TEXT("CBRQuarterColor"));
+					FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescQD, CBRQuarterDepthRefs[Slot], TEXT("CBRQuarterDepth"));
+				}
 			}
-
-			if (!CBRSceneDepthRef0.GetReference()) {
-				GRenderTargetPool.FindFreeElement(RHICmdList, DescD, CBRSceneDepthRef0, TEXT("CBRSceneDepthPrev"));
+			else
+			{
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescC, CBRSceneColorRef1, TEXT("CBRSeneColor"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescC, CBRSceneColorRef0, TEXT("CBRSeneColorPrev"));
 			}
-
-			if (!CBROutput.GetReference()) {
+			if (bCBRSecondHistory)
+			{
+				const uint64 CBRTargetBytes =
+					uint64(DescC.Extent.X) * DescC.Extent.Y * DescC.NumSamples * GPixelFormats[DescC.Format].BlockBytes +
+					uint64(DescD.Extent.X) * DescD.Extent.Y * DescD.NumSamples * GPixelFormats[DescD.Format].BlockBytes;
+				//两个相位各多一组target
+				bCBRSecondHistory = CBRTargetBytes * 2 <= uint64(FMath::Max(CVarMobileCBRSecondHistoryBudgetMB.GetValueOnRenderThread(), 0)) * 1024 * 1024;
+			}
+			if (bCBRSecondHistory)
+			{
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescC, CBRSceneColorN2Ref1, TEXT("CBRSeneColorN2"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescC, CBRSceneColorN2Ref0, TEXT("CBRSeneColorN2Prev"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescD, CBRSceneDepthN2Ref1, TEXT("CBRSceneDepthN2"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescD, CBRSceneDepthN2Ref0, TEXT("CBRSceneDepthN2Prev"));
+			}
+			if (bCBRSplitSamples)
+			{
+				const FPooledRenderTargetDesc DescS = FPooledRenderTargetDesc::Create2DDesc(FIntPoint(DescC.Extent.X * 2, DescC.Extent.Y), PF_R32_UINT, FClearValueBinding::Black, TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false);
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescS, CBRSplitColorRef1, TEXT("CBRSplitColor"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescS, CBRSplitColorRef0, TEXT("CBRSplitColorPrev"));
+			}
+			if (bCBRCompactDepth)
+			{
+				//深度留在TileMemory里, 只保存R16F的逐sample深度作为历史
+				FPooledRenderTargetDesc DescDM = DescD;
+				DescDM.TargetableFlags |= TexCreate_Memoryless;
+				const FPooledRenderTargetDesc DescDH = GetCBRTargetDesc(FPooledRenderTargetDesc::Create2DDesc(SceneContext.GetBufferSizeXY(), PF_R16F, FClearValueBinding::Black, TexCreate_None, TexCreate_RenderTargetable, false));
+
+				GRenderTargetPool.FindFreeElement(RHICmdList, DescDM, CBRSceneDepthMemoryless, TEXT("CBRSceneDepthMemoryless"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescDH, CBRDepthHistoryRef1, TEXT("CBRDepthHistory"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescDH, CBRDepthHistoryRef0, TEXT("CBRDepthHistoryPrev"));
+			}
+			else if (!CBRData::bQuarterRate)
+			{
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescD, CBRSceneDepthRef1, TEXT("CBRSceneDepth"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescD, CBRSceneDepthRef0, TEXT("CBRSceneDepthPrev"));
+			}
+			if (CBRFrameInterpolation > 0)
+			{
+				//插值需要上一帧的重建结果, 两个输出交替使用
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescO, CBROutputRef1, TEXT("CBROutput"));
+				FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescO, CBROutputRef0, TEXT("CBROutputPrev"));
+				GRenderTargetPool.FindFreeElement(RHICmdList, DescO, CBRInterpolatedOutput, TEXT("CBRInterpolatedOutput"));
+			}
+			else if (!bCBRReconstructPS)
+			{
 				GRenderTargetPool.FindFreeElement(RHICmdList, DescO, CBROutput, TEXT("CBROutput"));
 			}
-
-			if (!CBROutputDepth.GetReference()) {
-				GRenderTargetPool.FindFreeElement(RHICmdList, DescOD, CBROutputDepth, TEXT("CBROutputDepth"));
+			GRenderTargetPool.FindFreeElement(RHICmdList, DescOD, CBROutputDepth, TEXT("CBROutputDepth"));
+			if (bCBRVelocity)
+			{
+				//只需要当前帧的速度, 和CBR target同样的2x MSAA布局
+				const FPooledRenderTargetDesc DescV = GetCBRTargetDesc(FPooledRenderTargetDesc::Create2DDesc(SceneContext.GetBufferSizeXY(), PF_G16R16, FClearValueBinding::Transparent, TexCreate_None, TexCreate_RenderTargetable | TexCreate_ShaderResource, false));
+				GRenderTargetPool.FindFreeElement(RHICmdList, DescV, CBRVelocity, TEXT("CBRVelocity"));
+			}
+		}
+		CBRData::AdvanceFrame(CBRViewHistory);
+		if (bCBRSecondHistory)
+		{
+			//每个相位有两组target轮流写: 交换后Ref0/Ref1是N和N-1, N2Ref是和当前帧同相位的N-2
+			const uint32 CurrentFrame = CBRData::FrameCount - 1;
+			const uint32 PrevFrame = CurrentFrame - 1;
+			const bool bSwapCurrent = ((CurrentFrame / 2) & 1) != 0;
+			const bool bSwapPrev = ((PrevFrame / 2) & 1) != 0;
+			const bool bSwap1 = CBRData::mFrameOffset ? bSwapCurrent : bSwapPrev;
+			const bool bSwap0 = CBRData::mFrameOffset ? bSwapPrev : bSwapCurrent;
+			if (bSwap1)
+			{
+				Swap(CBRSceneColorRef1, CBRSceneColorN2Ref1);
+				Swap(CBRSceneDepthRef1, CBRSceneDepthN2Ref1);
+			}
+			if (bSwap0)
+			{
+				Swap(CBRSceneColorRef0, CBRSceneColorN2Ref0);
+				Swap(CBRSceneDepthRef0, CBRSceneDepthN2Ref0);
 			}
 		}
-		CBRData::mFrameOffset = CBRData::FrameCount % 2;
-		++CBRData::FrameCount;
-		CBRSceneColor = CBRData::mFrameOffset ? CBRSceneColorRef1->GetRenderTargetItem().TargetableTexture : CBRSceneColorRef0->GetRenderTargetItem().TargetableTexture;
-		CBRSceneDepth = CBRData::mFrameOffset ? CBRSceneDepthRef1->GetRenderTargetItem().TargetableTexture : CBRSceneDepthRef0->GetRenderTargetItem().TargetableTexture;
+		if (CBRFrameInterpolation > 0)
+		{
+			CBROutput = CBRData::mFrameOffset ? CBROutputRef1 : CBROutputRef0;
+		}
+		if (CBRData::bQuarterRate)
+		{
+			CBRSceneColor = CBRQuarterColorRefs[CBRData::mFrameOffset]->GetRenderTargetItem().TargetableTexture;
+		}
+		else
+		{
+			CBRSceneColor = CBRData::mFrameOffset ? CBRSceneColorRef1->GetRenderTargetItem().TargetableTexture : CBRSceneColorRef0->GetRenderTargetItem().TargetableTexture;
+		}
+		if (bCBRSplitSamples)
+		{
+			const FSceneRenderTargetItem& SplitColorItem = CBRData::mFrameOffset ? CBRSplitColorRef1->GetRenderTargetItem() : CBRSplitColorRef0->GetRenderTargetItem();
+			CBRSplitColor = SplitColorItem.ShaderResourceTexture;
+			CBRSplitColorUAV = SplitColorItem.UAV;
+			RHICmdList.Transition(FRHITransitionInfo(CBRSplitColor, ERHIAccess::Unknown, ERHIAccess::UAVGraphics));
+		}
+		if (bCBRCompactDepth)
+		{
+			CBRSceneDepth = CBRSceneDepthMemoryless->GetRenderTargetItem().TargetableTexture;
+			CBRDepthHistory = CBRData::mFrameOffset ? CBRDepthHistoryRef1->GetRenderTargetItem().TargetableTexture : CBRDepthHistoryRef0->GetRenderTargetItem().TargetableTexture;
+		}
+		else if (CBRData::bQuarterRate)
+		{
+			CBRSceneDepth = CBRQuarterDepthRefs[CBRData::mFrameOffset]->GetRenderTargetItem().TargetableTexture;
+		}
+		else
+		{
+			CBRSceneDepth = CBRData::mFrameOffset ? CBRSceneDepthRef1->GetRenderTargetItem().TargetableTexture : CBRSceneDepthRef0->GetRenderTargetItem().TargetableTexture;
+		}
 
 		CBRData::mDownsizeFactor.X = 2.f;
 		CBRData::mDownsizeFactor.Y = 2.f;
+
+		//Full prepass只画本帧slot的像素, 结果留在CBR深度里给base pass做early-Z (只有quarter rate, 见CBRInitForward)
+		if (bIsFullPrepassEnabled)
+		{
+			CBRRenderFullPrepass(RHICmdList, CBRSceneDepth);
+		}
 	}
 	//
 
+	// With split samples the colour samples leave the tile through the split pass, so the last pass doesn't store them
+	const bool bSplitInFirstPass = !(bRequiresMultiPass || bRequiresPixelProjectedPlanarRelfectionPass);
 	FRHIRenderPassInfo SceneColorRenderPassInfo(
 		CBRData::bCBR ? CBRSceneColor : SceneColor,
-		CBRData::bCBR ? ERenderTargetActions::Clear_Store : ColorTargetAction,
+		CBRData::bCBR ? ((bCBRSplitSamples && bSplitInFirstPass) ? ERenderTargetActions::Clear_DontStore : ERenderTargetActions::Clear_Store) : ColorTargetAction,
 		CBRData::bCBR ? nullptr : SceneColorResolve,
 		CBRData::bCBR ? CBRSceneDepth : SceneDepth,
 		DepthTargetAction,
@@ -1208,6 +1732,13 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 	);
 
 	SceneColorRenderPassInfo.SubpassHint = ESubpassHint::DepthReadSubpass;
+	if (bCBRCompactDepth)
+	{
+		// MRT1 is only written by CBRExportDepthHistory at the end of the pass, depth is never stored
+		SceneColorRenderPassInfo.ColorRenderTargets[1].RenderTarget = CBRDepthHistory;
+		SceneColorRenderPassInfo.ColorRenderTargets[1].Action = ERenderTargetActions::DontLoad_Store;
+		SceneColorRenderPassInfo.DepthStencilRenderTarget.Action = EDepthStencilTargetActions::ClearDepthStencil_DontStoreDepthStencil;
+	}
 	if (!bIsFullPrepassEnabled)
 	{
 		SceneColorRenderPassInfo.NumOcclusionQueries = ComputeNumOcclusionQueriesToBatch();
@@ -1305,7 +1836,15 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 		if (bRequiresPixelProjectedPlanarRelfectionPass)
 		{
 			const FPlanarReflectionSceneProxy* PlanarReflectionSceneProxy = Scene ? Scene->GetForwardPassGlobalPlanarReflection() : nullptr;
-			RenderPixelProjectedReflection(RHICmdList, SceneContext, PlanarReflectionSceneProxy);
+			//CBR: 只投影本帧着色的sample, 反射跟着SceneColor一起重建. PPR会关掉MSAA, 所以只有quarter rate
+			if (CBRData::bCBR && CBRData::bQuarterRate)
+			{
+				CBRRenderPixelProjectedReflection(RHICmdList, View, PlanarReflectionSceneProxy);
+			}
+			else
+			{
+				RenderPixelProjectedReflection(RHICmdList, SceneContext, PlanarReflectionSceneProxy);
+			}
 
 			FRHITransitionInfo TranslucentRenderPassTransitions[] = {
 			FRHITransitionInfo(CBRData::bCBR ? CBRSceneColor : SceneColor, ERHIAccess::SRVMask, ERHIAccess::RTV),
@@ -1343,7 +1882,7 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 
 		FRHIRenderPassInfo TranslucentRenderPassInfo(
 			CBRData::bCBR ? CBRSceneColor : SceneColor,
-			CBRData::bCBR ? ERenderTargetActions::Load_Store : SceneColorResolve ? ERenderTargetActions::Load_Resolve : ERenderTargetActions::Load_Store,
+			CBRData::bCBR ? (bCBRSplitSamples ? ERenderTargetActions::Load_DontStore : ERenderTargetActions::Load_Store) : SceneColorResolve ? ERenderTargetActions::Load_Resolve : ERenderTargetActions::Load_Store,
 			CBRData::bCBR ? nullptr : SceneColorResolve,
 			CBRData::bCBR ? CBRSceneDepth : SceneDepth ,
 			DepthTargetAction, 
@@ -1377,7 +1916,7 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 	}
 	
 	// Draw translucency.
-	if (ViewFamily.EngineShowFlags.Translucency)
+	if (ViewFamily.EngineShowFlags.Translucency && CBRTranslucencyFactor == 0)
 	{
 		CSV_SCOPED_TIMING_STAT_EXCLUSIVE(RenderTranslucency);
 		SCOPE_CYCLE_COUNTER(STAT_TranslucencyDrawTime);
@@ -1400,6 +1939,17 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 		}
 	}
 
+	//CBR Code
+	if (bCBRCompactDepth)
+	{
+		CBRExportDepthHistory(RHICmdList, View);
+	}
+	if (bCBRSplitSamples)
+	{
+		CBRSplitSamples(RHICmdList, View, CBRSplitColorUAV);
+	}
+	//
+
 	// Pre-tonemap before MSAA resolve (iOS only)
 	if (!bGammaSpace)
 	{
@@ -1410,84 +1960,151 @@ FRHITexture* FMobileSceneRenderer::RenderForward(FRHICommandListImmediate& RHICm
 	RHICmdList.EndRenderPass();
 
 	//CBR Code
-	//设置回原始rt TODO: 不知道有无其他更好的做法
+	//重建和拷贝都放在RenderPass之外: Vulkan不允许在RenderPass内Dispatch或Copy
 	if (CBRData::bCBR) {
-		FRHIRenderPassInfo OriginSceneColorRenderPassInfo(
-			SceneColor,
-			ERenderTargetActions::Clear_Store,
-			nullptr,
-			SceneDepth,
-			DepthTargetAction,
-			nullptr, // we never resolve scene depth on mobile
-			ShadingRateTexture,
-			VRSRB_Sum,
-			FExclusiveDepthStencil::DepthWrite_StencilWrite
-		);
-		RHICmdList.BeginRenderPass(OriginSceneColorRenderPassInfo, TEXT("After CBR Reconstruct"));
+		check(RHICmdList.IsOutsideRenderPass());
 
-		//CBR Code 重建Color
-		//TODO: 在一个Pass中作为RT的texture好像无法被用作shader resource 
-		//为了取到当前帧的CBR Target只能把重建扔到新Pass里做
+		if (bCBRVelocity)
 		{
-			CBRUniformBuffer.FrameOffset = float(CBRData::mFrameOffset);
-			CBRUniformBuffer.Flags |= 0x40;
+			CBRRenderVelocities(RHICmdList, View, CBRData::mFrameOffset ? CBRSceneDepthRef1 : CBRSceneDepthRef0);
+		}
 
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderMotionVectors.GetValueOnRenderThread() ? 0x01 : 0;
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderMissingPixels.GetValueOnRenderThread() ? 0x02 : 0;
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderQtrMotionPixels.GetValueOnRenderThread() ? 0x04 : 0;
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderCheckerPatternOdd.GetValueOnRenderThread() ? 0x08 : 0;
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderCheckerPatternEven.GetValueOnRenderThread() ? 0x10 : 0;
-			CBRUniformBuffer.Flags |= CVarMobileCBRRenderObstructedPixels.GetValueOnRenderThread() ? 0x20 : 0;
+		//CBR Code 重建Color
+		CBRUpdateUniformBuffer(View);
+		CBRInputs CBRInput(CBRSceneColorRef1, bCBRCompactDepth ? CBRDepthHistoryRef1 : CBRSceneDepthRef1, CBRSceneColorRef0, bCBRCompactDepth ? CBRDepthHistoryRef0 : CBRSceneDepthRef0);
+		CBRInput.bCompactDepth = bCBRCompactDepth;
+		CBRInput.bMultiView = bCBRMultiView;
+		if (bCBRVelocity)
+		{
+			CBRInput.Velocity = CBRVelocity;
+		}
+		if (bCBRSecondHistory)
+		{
+			CBRInput.SceneColorRef2 = CBRData::mFrameOffset ? CBRSceneColorN2Ref1 : CBRSceneColorN2Ref0;
+			CBRInput.SceneDepthRef2 = CBRData::mFrameOffset ? CBRSceneDepthN2Ref1 : CBRSceneDepthN2Ref0;
+		}
+		if (bCBRSplitSamples)
+		{
+			RHICmdList.Transition(FRHITransitionInfo(CBRSplitColor, ERHIAccess::UAVGraphics, ERHIAccess::SRVMask));
+			CBRInput.SceneColorRef0 = CBRSplitColorRef0;
+			CBRInput.SceneColorRef1 = CBRSplitColorRef1;
+			CBRInput.bSplitSamples = true;
+		}
+		//手动resolve: 没有MSAA surface时直接写回SceneColor
+		FRHITexture* CBRResolveTarget = SceneColorResolve ? SceneColorResolve : SceneColor;
+		if (bCBRReconstructPS)
+		{
+			//像素着色器直接写全分辨率SceneColor, 省掉Dispatch和Copy
+			CBRReconstructPassPS(RHICmdList, View, CBRInput, CBRResolveTarget);
+		}
+		else
+		{
+			if (CBRData::bQuarterRate)
+			{
+				CBRReconstructQuarterRatePass(RHICmdList, View, CBROutput);
+			}
+			else
+			{
+				CBRReconstructPass(RHICmdList, View, CBRInput, CBROutput);
+			}
+			RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+			//重建结束
 
-			CBRUniformBuffer.DepthTolerance = 0.1f;
+			FRHITexture* CBRReconstructed = CBROutput->GetRenderTargetItem().ShaderResourceTexture;
+			if (CBRFrameInterpolation > 0)
+			{
+				CBRInterpolatePass(RHICmdList, View, CBRInput, CBROutput, CBRData::mFrameOffset ? CBROutputRef0 : CBROutputRef1, CBRInterpolatedOutput);
+				if (CBRFrameInterpolation == 2)
+				{
+					CBRReconstructed = CBRInterpolatedOutput->GetRenderTargetItem().ShaderResourceTexture;
+				}
+			}
 
-			//列向量
-			static FMatrix PrevInvViewProj = View.ViewMatrices.GetInvViewProjectionMatrix();
-			FMatrix ViewProj = View.ViewMatrices.GetViewProjectionMatrix();
-			FMatrix InvViewProj = View.ViewMatrices.GetInvViewProjectionMatrix();
+			CopyCBROutput(RHICmdList, CBRReconstructed, CBRResolveTarget);
+		}
 
-			CBRUniformBuffer.LinearZTransform[0] = InvViewProj.M[2][2];
-			CBRUniformBuffer.LinearZTransform[1] = InvViewProj.GetTransposed().M[3][2];
-			CBRUniformBuffer.LinearZTransform[2] = InvViewProj.GetTransposed().M[2][3];
-			CBRUniformBuffer.LinearZTransform[3] = InvViewProj.M[3][3];
+		//半透明不参与棋盘重建, 低分辨率画完再合成
+		if (CBRTranslucencyFactor > 0 && ViewFamily.EngineShowFlags.Translucency)
+		{
+			CSV_SCOPED_TIMING_STAT_EXCLUSIVE(RenderTranslucency);
+			SCOPE_CYCLE_COUNTER(STAT_TranslucencyDrawTime);
+			CBRRenderSeparateTranslucency(RHICmdList, View, ViewList, CBRData::mFrameOffset ? CBRSceneDepthRef1 : CBRSceneDepthRef0, CBRResolveTarget, CBRTranslucencyFactor);
+			RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+		}
+	}
+	//
 
+	return SceneColorResolve ? SceneColorResolve : SceneColor;
+}
 
-			CBRUniformBuffer.CurrViewProj = ViewProj;
-			CBRUniformBuffer.PrevInvViewProj = PrevInvViewProj;
-			PrevInvViewProj = View.ViewMatrices.GetInvViewProjectionMatrix();
+FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> ViewList, const FSortedLightSetSceneInfo& SortedLightSet)
+{
+	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
 
-			CBRUniformBufferRHI.UpdateUniformBufferImmediate(CBRUniformBuffer);
-		}
-		CBRInputs CBRInput(CBRSceneColorRef1, CBRSceneDepthRef1, CBRSceneColorRef0, CBRSceneDepthRef0);
-		CBRReconstructPass(RHICmdList, View, CBRInput, CBROutput);
-		RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
-		//重建结束
-		//手动resolve
-		RHICmdList.SetViewport(0.0f, 0.0f, 0.0f, SceneColor->GetTexture2D()->GetSizeX(), SceneColor->GetTexture2D()->GetSizeY(), 1.0f);
-		RHICmdList.CopyToResolveTarget(CBROutput->GetRenderTargetItem().TargetableTexture, SceneColorResolve, OriginSceneColorRenderPassInfo.ResolveParameters);
+	//CBR Code
+	//延迟管线没有MSAA(GBuffer由shading subpass逐像素读取), 只能走quarter rate: 每帧只着色2x2中的一个像素
+	const FViewInfo& View = *ViewList[0];
+	CBRData::bCBR = CBR_DEFERRED_PASSES_USE_CBR_VIEWPORT && CVarMobileCBR.GetValueOnRenderThread() != 0 && CVarMobileCBRDeferred.GetValueOnRenderThread() != 0
+		&& CBRData::SupportsPlatform(ShaderPlatform) && !bIsFullPrepassEnabled && !View.bIsReflectionCapture
+		&& (!(View.bIsSceneCapture || View.bIsPlanarReflection) || CVarMobileCBRSceneCaptures.GetValueOnRenderThread() != 0);
+	CBRData::bQuarterRate = CBRData::bCBR;
+	bool bCBRHistoryValid = false;
+	CBRViewHistory = CBRData::bCBR ? CBRData::BeginView(View, bCBRHistoryValid) : nullptr;
+	CBRData::bSpatialOnly = CBRData::bCBR && !bCBRHistoryValid;
+	CBRData::mDownsizeFactor = FVector2D(1.f, 1.f);
+	FRHITexture* SceneColorSurface = SceneContext.GetSceneColorSurface();
+	FRHITexture* SceneDepthSurface = SceneContext.GetSceneDepthSurface();
+	FRHITexture* GBufferATexture = SceneContext.GetGBufferATexture().GetReference();
+	FRHITexture* GBufferBTexture = SceneContext.GetGBufferBTexture().GetReference();
+	FRHITexture* GBufferCTexture = SceneContext.GetGBufferCTexture().GetReference();
+	FRHITexture* SceneDepthAuxTexture = MobileRequiresSceneDepthAux(ShaderPlatform) ? SceneContext.SceneDepthAux->GetRenderTargetItem().ShaderResourceTexture.GetReference() : nullptr;
+	if (CBRData::bCBR)
+	{
+		CBRUniformBufferRHI = TUniformBufferRef<FCBRUniformBuffer>::CreateUniformBufferImmediate(CBRUniformBuffer, EUniformBufferUsage::UniformBuffer_SingleFrame);
 
-		RHICmdList.EndRenderPass();
+		//颜色和深度是重建的历史, 必须存下来; GBuffer沿用场景GBuffer的flag, 单pass时仍然是memoryless
+		FPooledRenderTargetDesc DescQC = GetCBRTargetDesc(SceneContext.GetSceneColor()->GetDesc());
+		FPooledRenderTargetDesc DescQD = GetCBRTargetDesc(SceneContext.SceneDepthZ->GetDesc());
+		DescQC.NumSamples = 1;
+		DescQD.NumSamples = 1;
+		for (int32 Slot = 0; Slot < 4; ++Slot)
+		{
+			FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescQC, CBRQuarterColorRefs[Slot], TEXT("CBRQuarterColor"));
+			FindCBRHistoryTarget(RHICmdList, CBRViewHistory, DescQD, CBRQuarterDepthRefs[Slot], TEXT("CBRQuarterDepth"));
+		}
+		auto GetQuarterRateGBufferDesc = [](FPooledRenderTargetDesc Desc) { Desc.Extent /= 2; return Desc; };
+		GRenderTargetPool.FindFreeElement(RHICmdList, GetQuarterRateGBufferDesc(SceneContext.GBufferA->GetDesc()), CBRGBufferA, TEXT("CBRGBufferA"));
+		GRenderTargetPool.FindFreeElement(RHICmdList, GetQuarterRateGBufferDesc(SceneContext.GBufferB->GetDesc()), CBRGBufferB, TEXT("CBRGBufferB"));
+		GRenderTargetPool.FindFreeElement(RHICmdList, GetQuarterRateGBufferDesc(SceneContext.GBufferC->GetDesc()), CBRGBufferC, TEXT("CBRGBufferC"));
+		if (SceneDepthAuxTexture)
+		{
+			GRenderTargetPool.FindFreeElement(RHICmdList, GetQuarterRateGBufferDesc(SceneContext.SceneDepthAux->GetDesc()), CBRSceneDepthAux, TEXT("CBRSceneDepthAux"));
+			SceneDepthAuxTexture = CBRSceneDepthAux->GetRenderTargetItem().ShaderResourceTexture.GetReference();
+		}
+		const FPooledRenderTargetDesc DescO = FPooledRenderTargetDesc::Create2DDesc(SceneContext.GetBufferSizeXY(), SceneContext.GetSceneColor()->GetDesc().Format, FClearValueBinding::Black, TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false);
+		GRenderTargetPool.FindFreeElement(RHICmdList, DescO, CBROutput, TEXT("CBROutput"));
 
-		//
+		CBRData::AdvanceFrame(CBRViewHistory);
+		SceneColorSurface = CBRQuarterColorRefs[CBRData::mFrameOffset]->GetRenderTargetItem().TargetableTexture;
+		SceneDepthSurface = CBRQuarterDepthRefs[CBRData::mFrameOffset]->GetRenderTargetItem().TargetableTexture;
+		GBufferATexture = CBRGBufferA->GetRenderTargetItem().TargetableTexture;
+		GBufferBTexture = CBRGBufferB->GetRenderTargetItem().TargetableTexture;
+		GBufferCTexture = CBRGBufferC->GetRenderTargetItem().TargetableTexture;
+		CBRData::mDownsizeFactor = FVector2D(2.f, 2.f);
 	}
-	
-	return SceneColorResolve ? SceneColorResolve : SceneColor;
-}
-
-FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> ViewList, const FSortedLightSetSceneInfo& SortedLightSet)
-{
-	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
+	//
 			
 	FRHITexture* ColorTargets[4] = {
-		SceneContext.GetSceneColorSurface(),
-		SceneContext.GetGBufferATexture().GetReference(),
-		SceneContext.GetGBufferBTexture().GetReference(),
-		SceneContext.GetGBufferCTexture().GetReference()
+		SceneColorSurface,
+		GBufferATexture,
+		GBufferBTexture,
+		GBufferCTexture
 	};
 
 	// Whether RHI needs to store GBuffer to system memory and do shading in separate render-pass
 	ERenderTargetActions GBufferAction = bRequiresMultiPass ? ERenderTargetActions::Clear_Store : ERenderTargetActions::Clear_DontStore;
-	EDepthStencilTargetActions DepthAction = bKeepDepthContent ? EDepthStencilTargetActions::ClearDepthStencil_StoreDepthStencil : EDepthStencilTargetActions::ClearDepthStencil_DontStoreDepthStencil;
+	// CBR depth is the reconstruction history of its slot and is always stored
+	EDepthStencilTargetActions DepthAction = (bKeepDepthContent || CBRData::bCBR) ? EDepthStencilTargetActions::ClearDepthStencil_StoreDepthStencil : EDepthStencilTargetActions::ClearDepthStencil_DontStoreDepthStencil;
 		
 	ERenderTargetActions ColorTargetsAction[4] = {ERenderTargetActions::Clear_Store, GBufferAction, GBufferAction, GBufferAction};
 	if (bIsFullPrepassEnabled)
@@ -1508,9 +2125,9 @@ FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHIC
 		BasePassInfo.ColorRenderTargets[ColorTargetIndex].Action = ColorTargetsAction[ColorTargetIndex];
 	}
 	
-	if (MobileRequiresSceneDepthAux(ShaderPlatform))
+	if (SceneDepthAuxTexture)
 	{
-		BasePassInfo.ColorRenderTargets[ColorTargetIndex].RenderTarget = SceneContext.SceneDepthAux->GetRenderTargetItem().ShaderResourceTexture.GetReference();
+		BasePassInfo.ColorRenderTargets[ColorTargetIndex].RenderTarget = SceneDepthAuxTexture;
 		BasePassInfo.ColorRenderTargets[ColorTargetIndex].ResolveTarget = nullptr;
 		BasePassInfo.ColorRenderTargets[ColorTargetIndex].ArraySlice = -1;
 		BasePassInfo.ColorRenderTargets[ColorTargetIndex].MipIndex = 0;
@@ -1518,7 +2135,7 @@ FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHIC
 		ColorTargetIndex++;
 	}
 
-	BasePassInfo.DepthStencilRenderTarget.DepthStencilTarget = SceneContext.GetSceneDepthSurface();
+	BasePassInfo.DepthStencilRenderTarget.DepthStencilTarget = SceneDepthSurface;
 	BasePassInfo.DepthStencilRenderTarget.ResolveTarget = nullptr;
 	BasePassInfo.DepthStencilRenderTarget.Action = DepthAction;
 	BasePassInfo.DepthStencilRenderTarget.ExclusiveDepthStencil = FExclusiveDepthStencil::DepthWrite_StencilWrite;
@@ -1619,10 +2236,10 @@ FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHIC
 		// SceneColor write, SceneDepth is read only
 		{
 			FRHIRenderPassInfo ShadingPassInfo(
-				SceneContext.GetSceneColorSurface(),
+				SceneColorSurface,
 				ERenderTargetActions::Load_Store,
 				nullptr,
-				SceneContext.GetSceneDepthSurface(),
+				SceneDepthSurface,
 				EDepthStencilTargetActions::LoadDepthStencil_StoreDepthStencil, 
 				nullptr,
 				nullptr,
@@ -1649,6 +2266,21 @@ FRHITexture* FMobileSceneRenderer::RenderDeferred(FRHICommandListImmediate& RHIC
 		}
 	}
 
+	//CBR Code
+	//光照后的结果按quarter rate重建, 再拷回全分辨率SceneColor
+	if (CBRData::bCBR)
+	{
+		check(RHICmdList.IsOutsideRenderPass());
+		CBRUpdateUniformBuffer(View);
+		CBRReconstructQuarterRatePass(RHICmdList, View, CBROutput);
+		RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+
+		FRHITexture* SceneColorTarget = SceneContext.GetSceneColorSurface();
+		CopyCBROutput(RHICmdList, CBROutput->GetRenderTargetItem().ShaderResourceTexture, SceneColorTarget);
+		return SceneColorTarget;
+	}
+	//
+
 	return ColorTargets[0];
 }
 
@@ -1878,6 +2510,83 @@ void FMobileSceneRenderer::CreateDirectionalLightUniformBuffers(FViewInfo& View)
 }
 
 //CBR Code
+//Uniform buffer of the reconstruct passes, the history matrices are kept across frames
+void FMobileSceneRenderer::CBRUpdateUniformBuffer(const FViewInfo& View)
+{
+	CBRUniformBuffer.FrameOffset = float(CBRData::mFrameOffset);
+	const int32 CBRHistoryValidation = CVarMobileCBRHistoryValidation.GetValueOnRenderThread();
+	CBRUniformBuffer.Flags |= CBRHistoryValidation == 1 ? 0x40 : 0;
+	CBRUniformBuffer.Flags |= CBRHistoryValidation == 2 ? 0x100 : 0;
+	//Reduced模式(没有逐sample着色)或view没有可用的历史: 只用当前帧做空间重建
+	CBRUniformBuffer.Flags |= CBRData::bSpatialOnly ? 0x80 : 0;
+
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderMotionVectors.GetValueOnRenderThread() ? 0x01 : 0;
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderMissingPixels.GetValueOnRenderThread() ? 0x02 : 0;
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderQtrMotionPixels.GetValueOnRenderThread() ? 0x04 : 0;
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderCheckerPatternOdd.GetValueOnRenderThread() ? 0x08 : 0;
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderCheckerPatternEven.GetValueOnRenderThread() ? 0x10 : 0;
+	CBRUniformBuffer.Flags |= CVarMobileCBRRenderObstructedPixels.GetValueOnRenderThread() ? 0x20 : 0;
+
+	CBRUniformBuffer.DepthTolerance = 0.1f;
+
+	//天空: 远于SkyDistance的像素只做旋转重投影
+	const float CBRSkyDistance = CVarMobileCBRSkyDistance.GetValueOnRenderThread();
+	CBRUniformBuffer.SkyDeviceZ = 0.f;
+	if (CBRSkyDistance > 0.f && View.IsPerspectiveProjection())
+	{
+		CBRUniformBuffer.Flags |= 0x200;
+		CBRUniformBuffer.SkyDeviceZ = 1.f / ((CBRSkyDistance + View.InvDeviceZToWorldZTransform.W) * View.InvDeviceZToWorldZTransform.Z);
+	}
+
+	//列向量
+	FMatrix ViewProj = View.ViewMatrices.GetViewProjectionMatrix();
+	FMatrix InvViewProj = View.ViewMatrices.GetInvViewProjectionMatrix();
+
+	//历史矩阵跟着view走; 没有view state的view只做空间重建, 用当前帧的矩阵
+	CBRData::FViewHistory NoHistory;
+	if (!CBRViewHistory)
+	{
+		NoHistory.ResetMatrices(InvViewProj);
+	}
+	CBRData::FViewHistory& History = CBRViewHistory ? *CBRViewHistory : NoHistory;
+
+	CBRUniformBuffer.LinearZTransform[0] = InvViewProj.M[2][2];
+	CBRUniformBuffer.LinearZTransform[1] = InvViewProj.GetTransposed().M[3][2];
+	CBRUniformBuffer.LinearZTransform[2] = InvViewProj.GetTransposed().M[2][3];
+	CBRUniformBuffer.LinearZTransform[3] = InvViewProj.M[3][3];
+
+
+	CBRUniformBuffer.CurrViewProj = ViewProj;
+	CBRUniformBuffer.PrevInvViewProj = History.PrevInvViewProj;
+	CBRUniformBuffer.InvDeviceZToWorldZTransform = View.InvDeviceZToWorldZTransform;
+	CBRUniformBuffer.PrevPrevInvViewProj = History.PrevPrevInvViewProj;
+	History.PrevPrevInvViewProj = History.PrevInvViewProj;
+	History.PrevInvViewProj = InvViewProj;
+
+	//Multiview: 右眼在第二层, 用自己的矩阵和历史重投影
+	CBRUniformBuffer.RightEyeCurrViewProj = ViewProj;
+	CBRUniformBuffer.RightEyePrevInvViewProj = CBRUniformBuffer.PrevInvViewProj;
+	if (View.bIsMobileMultiViewEnabled && Views.Num() > 1)
+	{
+		const FViewInfo& RightEye = Views[1];
+		CBRUniformBuffer.RightEyeCurrViewProj = RightEye.ViewMatrices.GetViewProjectionMatrix();
+		CBRUniformBuffer.RightEyePrevInvViewProj = History.RightEyePrevInvViewProj;
+		History.RightEyePrevInvViewProj = RightEye.ViewMatrices.GetInvViewProjectionMatrix();
+	}
+
+	//Quarter rate: 每个slot记录着色时的InvViewProj, 用来从三帧历史里重投影
+	if (CBRData::bQuarterRate)
+	{
+		History.HistoryInvViewProj[CBRData::mFrameOffset] = InvViewProj;
+	}
+	for (int32 Slot = 0; Slot < 4; ++Slot)
+	{
+		CBRUniformBuffer.HistoryInvViewProj[Slot] = History.HistoryInvViewProj[Slot];
+	}
+
+	CBRUniformBufferRHI.UpdateUniformBufferImmediate(CBRUniformBuffer);
+}
+
 //Color Resolve
 class FCBRReconstructCS : public FGlobalShader
 {
@@ -1891,9 +2600,27 @@ public:
 	static const uint32 ThreadGroupSizeX = 16;
 	static const uint32 ThreadGroupSizeY = 16;
 
+	class FCompactDepthDim : SHADER_PERMUTATION_BOOL("CBR_COMPACT_DEPTH");
+	class FSplitSamplesDim : SHADER_PERMUTATION_BOOL("CBR_SPLIT_SAMPLES");
+	class FVelocityDim : SHADER_PERMUTATION_BOOL("CBR_VELOCITY");
+	class FSecondHistoryDim : SHADER_PERMUTATION_BOOL("CBR_SECOND_HISTORY");
+	class FMultiViewDim : SHADER_PERMUTATION_BOOL("CBR_MULTI_VIEW");
+	using FPermutationDomain = TShaderPermutationDomain<FCompactDepthDim, FSplitSamplesDim, FVelocityDim, FSecondHistoryDim, FMultiViewDim>;
+
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsMobilePlatform(Parameters.Platform);
+		FPermutationDomain PermutationVector(Parameters.PermutationId);
+		if (!CBR_VELOCITY_PASS_USES_CBR_VIEWPORT && PermutationVector.Get<FVelocityDim>())
+		{
+			return false;
+		}
+		// Multiview only reads the plain 2x MSAA colour and depth arrays
+		return IsMobilePlatform(Parameters.Platform)
+			&& (!PermutationVector.Get<FMultiViewDim>()
+			|| (!PermutationVector.Get<FCompactDepthDim>()
+			&& !PermutationVector.Get<FSplitSamplesDim>()
+			&& !PermutationVector.Get<FVelocityDim>()
+			&& !PermutationVector.Get<FSecondHistoryDim>()));
 	}
 
 	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
@@ -1908,6 +2635,11 @@ public:
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInDepth2x0)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInColor2x1)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInDepth2x1)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, SplitInColor2x0)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, SplitInColor2x1)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, Velocity2x)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInColor2x2)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInDepth2x2)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
 	END_SHADER_PARAMETER_STRUCT()
 };
@@ -1918,10 +2650,220 @@ IMPLEMENT_SHADER_TYPE(, FCBRReconstructCS, TEXT("/Engine/Private/CBR/CBRReconstr
 void FMobileSceneRenderer::CBRReconstructPass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, TRefCountPtr<IPooledRenderTarget>& OutputTexture) {
 	FRDGBuilder GraphBuilder(RHICmdList);
 
-	TShaderMapRef<FCBRReconstructCS> ComputeShader(View.ShaderMap);
+	FCBRReconstructCS::FPermutationDomain PermutationVector;
+	PermutationVector.Set<FCBRReconstructCS::FCompactDepthDim>(inputs.bCompactDepth);
+	PermutationVector.Set<FCBRReconstructCS::FSplitSamplesDim>(inputs.bSplitSamples);
+	PermutationVector.Set<FCBRReconstructCS::FVelocityDim>(inputs.Velocity.IsValid());
+	PermutationVector.Set<FCBRReconstructCS::FSecondHistoryDim>(inputs.SceneColorRef2.IsValid());
+	PermutationVector.Set<FCBRReconstructCS::FMultiViewDim>(inputs.bMultiView);
+	TShaderMapRef<FCBRReconstructCS> ComputeShader(View.ShaderMap, PermutationVector);
 
 	FCBRReconstructCS::FParameters* CSShaderParameters = GraphBuilder.AllocParameters<FCBRReconstructCS::FParameters>();
 
+	// CBROutput is allocated with UAV access, write it directly so it can serve as history
+	FRDGTextureRef Output = GraphBuilder.RegisterExternalTexture(OutputTexture, TEXT("CBRReconstructOutput"));
+
+	if (inputs.bSplitSamples)
+	{
+		CSShaderParameters->SplitInColor2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef0, TEXT("CBRSplitColor0"));
+		CSShaderParameters->SplitInColor2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef1, TEXT("CBRSplitColor1"));
+	}
+	else
+	{
+		CSShaderParameters->DownSizedInColor2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef0, TEXT("CBRSceneColor0"), ERenderTargetTexture::Targetable);
+		CSShaderParameters->DownSizedInColor2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef1, TEXT("CBRSceneColor1"), ERenderTargetTexture::Targetable);
+	}
+	CSShaderParameters->DownSizedInDepth2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef0, TEXT("CBRSceneDepth0"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->DownSizedInDepth2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef1, TEXT("CBRSceneDepth1"), ERenderTargetTexture::Targetable);
+	if (inputs.Velocity.IsValid())
+	{
+		CSShaderParameters->Velocity2x = GraphBuilder.RegisterExternalTexture(inputs.Velocity, TEXT("CBRVelocity"), ERenderTargetTexture::Targetable);
+	}
+	if (inputs.SceneColorRef2.IsValid())
+	{
+		CSShaderParameters->DownSizedInColor2x2 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef2, TEXT("CBRSceneColorN2"), ERenderTargetTexture::Targetable);
+		CSShaderParameters->DownSizedInDepth2x2 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef2, TEXT("CBRSceneDepthN2"), ERenderTargetTexture::Targetable);
+	}
+	CSShaderParameters->OutputTexture = GraphBuilder.CreateUAV(Output);
+	CSShaderParameters->CBRUniformBuffer = CBRUniformBufferRHI;
+
+	//Multiview: z是眼睛
+	FIntVector GroupCount = FComputeShaderUtils::GetGroupCount(View.ViewRect.Size(), FCBRReconstructCS::TexelsPerThreadGroup);//线程组数量
+	GroupCount.Z = inputs.bMultiView ? 2 : 1;
+
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("CBRReconstruct(CS)"),
+		ERDGPassFlags::Compute,
+		ComputeShader,
+		CSShaderParameters,
+		GroupCount
+	);
+	GraphBuilder.QueueTextureExtraction(Output, &OutputTexture);
+	GraphBuilder.Execute();
+};
+
+
+class FCBRReconstructPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRReconstructPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRReconstructPS, FGlobalShader);
+
+public:
+	using FPermutationDomain = FCBRReconstructCS::FPermutationDomain;
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		// The velocity, N-2 and multiview targets are only read by the compute reconstruct
+		FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return IsMobilePlatform(Parameters.Platform)
+			&& !PermutationVector.Get<FCBRReconstructCS::FMultiViewDim>()
+			&& !PermutationVector.Get<FCBRReconstructCS::FVelocityDim>()
+			&& !PermutationVector.Get<FCBRReconstructCS::FSecondHistoryDim>();
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FCBRUniformBuffer, CBRUniformBuffer)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DownSizedInColor2x0)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DownSizedInDepth2x0)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DownSizedInColor2x1)
+		SHADER_PARAMETER_TEXTURE(Texture2D, DownSizedInDepth2x1)
+		SHADER_PARAMETER_TEXTURE(Texture2D<uint>, SplitInColor2x0)
+		SHADER_PARAMETER_TEXTURE(Texture2D<uint>, SplitInColor2x1)
+		SHADER_PARAMETER(FIntPoint, OutputExtent)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRReconstructPS, TEXT("/Engine/Private/CBR/CBRReconstruct.usf"), TEXT("mainPS"), SF_Pixel);
+
+void FMobileSceneRenderer::CBRReconstructPassPS(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, FRHITexture* OutputTexture)
+{
+	check(RHICmdList.IsOutsideRenderPass());
+
+	FRHITexture* SceneColor0 = inputs.SceneColorRef0->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* SceneColor1 = inputs.SceneColorRef1->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* SceneDepth0 = inputs.SceneDepthRef0->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* SceneDepth1 = inputs.SceneDepthRef1->GetRenderTargetItem().TargetableTexture;
+
+	FRHITransitionInfo InputTransitions[] = {
+		FRHITransitionInfo(SceneColor0, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(SceneColor1, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(SceneDepth0, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(SceneDepth1, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(OutputTexture, ERHIAccess::Unknown, ERHIAccess::RTV)
+	};
+	RHICmdList.Transition(MakeArrayView(InputTransitions, UE_ARRAY_COUNT(InputTransitions)));
+
+	// Every pixel of the view is written, nothing to load
+	FRHIRenderPassInfo RPInfo(OutputTexture, ERenderTargetActions::DontLoad_Store);
+	RHICmdList.BeginRenderPass(RPInfo, TEXT("CBRReconstruct(PS)"));
+	{
+		SCOPED_DRAW_EVENT(RHICmdList, CBRReconstructPS);
+
+		FCBRReconstructCS::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FCBRReconstructCS::FCompactDepthDim>(inputs.bCompactDepth);
+		PermutationVector.Set<FCBRReconstructCS::FSplitSamplesDim>(inputs.bSplitSamples);
+
+		TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+		TShaderMapRef<FCBRReconstructPS> PixelShader(View.ShaderMap, PermutationVector);
+
+		FGraphicsPipelineStateInitializer GraphicsPSOInit;
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+		extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+		FCBRReconstructPS::FParameters PassParameters;
+		PassParameters.CBRUniformBuffer = CBRUniformBufferRHI;
+		if (inputs.bSplitSamples)
+		{
+			PassParameters.SplitInColor2x0 = SceneColor0;
+			PassParameters.SplitInColor2x1 = SceneColor1;
+		}
+		else
+		{
+			PassParameters.DownSizedInColor2x0 = SceneColor0;
+			PassParameters.DownSizedInColor2x1 = SceneColor1;
+		}
+		PassParameters.DownSizedInDepth2x0 = SceneDepth0;
+		PassParameters.DownSizedInDepth2x1 = SceneDepth1;
+		PassParameters.OutputExtent = FIntPoint(OutputTexture->GetSizeXYZ().X, OutputTexture->GetSizeXYZ().Y);
+		SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+		RHICmdList.SetViewport(View.ViewRect.Min.X, View.ViewRect.Min.Y, 0.0f, View.ViewRect.Max.X, View.ViewRect.Max.Y, 1.0f);
+
+		const FIntPoint TargetSize = View.ViewRect.Size();
+		DrawRectangle(
+			RHICmdList,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			TargetSize,
+			TargetSize,
+			VertexShader,
+			EDRF_UseTriangleOptimization);
+	}
+	RHICmdList.EndRenderPass();
+	RHICmdList.Transition(FRHITransitionInfo(OutputTexture, ERHIAccess::RTV, ERHIAccess::SRVMask));
+}
+
+//Quarter rate
+class FCBRReconstructQuarterRateCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRReconstructQuarterRateCS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRReconstructQuarterRateCS, FGlobalShader);
+
+public:
+	static const FIntPoint TexelsPerThreadGroup;
+
+	static const uint32 ThreadGroupSizeX = 16;
+	static const uint32 ThreadGroupSizeY = 16;
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FCBRUniformBuffer, CBRUniformBuffer)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterColor0)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterColor1)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterColor2)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterColor3)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterDepth0)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterDepth1)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterDepth2)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, QuarterDepth3)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+};
+const FIntPoint FCBRReconstructQuarterRateCS::TexelsPerThreadGroup(ThreadGroupSizeX, ThreadGroupSizeY);
+
+IMPLEMENT_SHADER_TYPE(, FCBRReconstructQuarterRateCS, TEXT("/Engine/Private/CBR/CBRReconstructQuarterRate.usf"), TEXT("mainCS"), SF_Compute);
+
+void FMobileSceneRenderer::CBRReconstructQuarterRatePass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, TRefCountPtr<IPooledRenderTarget>& OutputTexture)
+{
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	TShaderMapRef<FCBRReconstructQuarterRateCS> ComputeShader(View.ShaderMap);
+
+	FCBRReconstructQuarterRateCS::FParameters* CSShaderParameters = GraphBuilder.AllocParameters<FCBRReconstructQuarterRateCS::FParameters>();
+
 	FRDGTextureRef Output = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2DDesc(
 		OutputTexture->GetDesc().Extent,
 		OutputTexture->GetDesc().Format,
@@ -1931,25 +2873,736 @@ void FMobileSceneRenderer::CBRReconstructPass(FRHICommandListImmediate& RHICmdLi
 		false),
 		TEXT("CBRReconstructOutput"));
 
-	CSShaderParameters->DownSizedInColor2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef0,TEXT("CBRSceneColor0"), ERenderTargetTexture::Targetable);
-	CSShaderParameters->DownSizedInDepth2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef0, TEXT("CBRSceneDepth0"), ERenderTargetTexture::Targetable);
-	CSShaderParameters->DownSizedInColor2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneColorRef1, TEXT("CBRSceneColor1"), ERenderTargetTexture::Targetable);
-	CSShaderParameters->DownSizedInDepth2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef1, TEXT("CBRSceneDepth1"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterColor0 = GraphBuilder.RegisterExternalTexture(CBRQuarterColorRefs[0], TEXT("CBRQuarterColor0"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterColor1 = GraphBuilder.RegisterExternalTexture(CBRQuarterColorRefs[1], TEXT("CBRQuarterColor1"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterColor2 = GraphBuilder.RegisterExternalTexture(CBRQuarterColorRefs[2], TEXT("CBRQuarterColor2"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterColor3 = GraphBuilder.RegisterExternalTexture(CBRQuarterColorRefs[3], TEXT("CBRQuarterColor3"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterDepth0 = GraphBuilder.RegisterExternalTexture(CBRQuarterDepthRefs[0], TEXT("CBRQuarterDepth0"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterDepth1 = GraphBuilder.RegisterExternalTexture(CBRQuarterDepthRefs[1], TEXT("CBRQuarterDepth1"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterDepth2 = GraphBuilder.RegisterExternalTexture(CBRQuarterDepthRefs[2], TEXT("CBRQuarterDepth2"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->QuarterDepth3 = GraphBuilder.RegisterExternalTexture(CBRQuarterDepthRefs[3], TEXT("CBRQuarterDepth3"), ERenderTargetTexture::Targetable);
 	CSShaderParameters->OutputTexture = GraphBuilder.CreateUAV(Output);
 	CSShaderParameters->CBRUniformBuffer = CBRUniformBufferRHI;
 
 	FComputeShaderUtils::AddPass(
 		GraphBuilder,
-		RDG_EVENT_NAME("CBRReconstruct(CS)"),
+		RDG_EVENT_NAME("CBRReconstructQuarterRate(CS)"),
 		ERDGPassFlags::Compute,
 		ComputeShader,
 		CSShaderParameters,
-		FComputeShaderUtils::GetGroupCount(View.ViewRect.Size(), FCBRReconstructCS::TexelsPerThreadGroup)//线程组数量
+		FComputeShaderUtils::GetGroupCount(View.ViewRect.Size(), FCBRReconstructQuarterRateCS::TexelsPerThreadGroup)
 	);
 	GraphBuilder.QueueTextureExtraction(Output, &OutputTexture);
 	GraphBuilder.Execute();
+}
+
+//Frame interpolation
+class FCBRInterpolateCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRInterpolateCS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRInterpolateCS, FGlobalShader);
+
+public:
+	static const FIntPoint TexelsPerThreadGroup;
+
+	static const uint32 ThreadGroupSizeX = 16;
+	static const uint32 ThreadGroupSizeY = 16;
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, CurrColor)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PrevColor)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInDepth2x0)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, DownSizedInDepth2x1)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+		SHADER_PARAMETER(FMatrix, MidInvViewProj)
+		SHADER_PARAMETER(FMatrix, CurrViewProj)
+		SHADER_PARAMETER(FMatrix, PrevViewProj)
+		SHADER_PARAMETER(FVector4, InvDeviceZToWorldZTransform)
+		SHADER_PARAMETER(float, DepthTolerance)
+	END_SHADER_PARAMETER_STRUCT()
+};
+const FIntPoint FCBRInterpolateCS::TexelsPerThreadGroup(ThreadGroupSizeX, ThreadGroupSizeY);
+
+IMPLEMENT_SHADER_TYPE(, FCBRInterpolateCS, TEXT("/Engine/Private/CBR/CBRInterpolate.usf"), TEXT("mainCS"), SF_Compute);
+
+void FMobileSceneRenderer::CBRInterpolatePass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, TRefCountPtr<IPooledRenderTarget>& CurrColor, TRefCountPtr<IPooledRenderTarget>& PrevColor, TRefCountPtr<IPooledRenderTarget>& OutputTexture)
+{
+	//只插值相机运动: 相机位置线性插值, 朝向球面插值, 投影用当前帧的
+	//上一帧的矩阵存在view自己的history里; 没有history的view两端都用当前帧
+	const FViewMatrices& CurrViewMatrices = View.ViewMatrices;
+	const bool bHasPrev = CBRViewHistory && CBRViewHistory->bHasInterpolateViewMatrices;
+	const FViewMatrices PrevViewMatrices = bHasPrev ? CBRViewHistory->InterpolateViewMatrices : CurrViewMatrices;
+
+	const FVector MidViewOrigin = FMath::Lerp(PrevViewMatrices.GetViewOrigin(), CurrViewMatrices.GetViewOrigin(), .5f);
+	const FQuat MidViewRotation = FQuat::Slerp(
+		FQuat(PrevViewMatrices.GetViewMatrix().RemoveTranslation()),
+		FQuat(CurrViewMatrices.GetViewMatrix().RemoveTranslation()),
+		.5f);
+	const FMatrix MidViewProj = FTranslationMatrix(-MidViewOrigin) * FQuatRotationMatrix(MidViewRotation) * CurrViewMatrices.GetProjectionMatrix();
+
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	TShaderMapRef<FCBRInterpolateCS> ComputeShader(View.ShaderMap);
+	FCBRInterpolateCS::FParameters* CSShaderParameters = GraphBuilder.AllocParameters<FCBRInterpolateCS::FParameters>();
+
+	CSShaderParameters->CurrColor = GraphBuilder.RegisterExternalTexture(CurrColor, TEXT("CBRInterpolateCurr"));
+	CSShaderParameters->PrevColor = GraphBuilder.RegisterExternalTexture(PrevColor, TEXT("CBRInterpolatePrev"));
+	CSShaderParameters->DownSizedInDepth2x0 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef0, TEXT("CBRSceneDepth0"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->DownSizedInDepth2x1 = GraphBuilder.RegisterExternalTexture(inputs.SceneDepthRef1, TEXT("CBRSceneDepth1"), ERenderTargetTexture::Targetable);
+	CSShaderParameters->OutputTexture = GraphBuilder.CreateUAV(GraphBuilder.RegisterExternalTexture(OutputTexture, TEXT("CBRInterpolated")));
+	CSShaderParameters->MidInvViewProj = MidViewProj.Inverse();
+	CSShaderParameters->CurrViewProj = CurrViewMatrices.GetViewProjectionMatrix();
+	CSShaderParameters->PrevViewProj = PrevViewMatrices.GetViewProjectionMatrix();
+	CSShaderParameters->InvDeviceZToWorldZTransform = View.InvDeviceZToWorldZTransform;
+	CSShaderParameters->DepthTolerance = 0.05f;
+
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("CBRInterpolate(CS)"),
+		ERDGPassFlags::Compute,
+		ComputeShader,
+		CSShaderParameters,
+		FComputeShaderUtils::GetGroupCount(View.ViewRect.Size(), FCBRInterpolateCS::TexelsPerThreadGroup)
+	);
+	GraphBuilder.Execute();
+
+	if (CBRViewHistory)
+	{
+		CBRViewHistory->InterpolateViewMatrices = CurrViewMatrices;
+		CBRViewHistory->bHasInterpolateViewMatrices = true;
+	}
+}
+
+//Spatial upscale
+class FCBRSpatialUpscalePS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRSpatialUpscalePS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRSpatialUpscalePS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, InputTexture)
+		SHADER_PARAMETER(FVector4, InputViewRect)
+		SHADER_PARAMETER(FVector4, OutputViewRect)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRSpatialUpscalePS, TEXT("/Engine/Private/CBR/CBRSpatialUpscale.usf"), TEXT("MainPS"), SF_Pixel);
+
+bool FMobileSceneRenderer::ShouldCBRSpatialUpscale() const
+{
+	// Only the LDR path, where the post processing chain has nothing to do but the upscale it replaces
+	const FViewInfo& View = Views[0];
+	return CBRData::bCBR
+		&& CVarMobileCBRSpatialUpscale.GetValueOnRenderThread() != 0
+		&& bGammaSpace && bRenderToSceneColor
+		&& Views.Num() == 1
+		&& View.ViewRect.Size() != View.UnscaledViewRect.Size()
+		&& !View.bIsSceneCapture && !View.bIsReflectionCapture
+		&& !FSceneRenderer::ShouldCompositeEditorPrimitives(View)
+		&& !(ViewFamily.EngineShowFlags.StereoRendering && ViewFamily.EngineShowFlags.HMDDistortion);
+}
+
+void FMobileSceneRenderer::CBRSpatialUpscalePass(FRDGBuilder& GraphBuilder, const FViewInfo& View, FRDGTextureRef InputTexture, FRDGTextureRef OutputTexture)
+{
+	TShaderMapRef<FCBRSpatialUpscalePS> PixelShader(View.ShaderMap);
+
+	const FIntRect OutputRect = View.UnscaledViewRect;
+	const bool bCoversOutput = OutputRect.Min == FIntPoint::ZeroValue && OutputRect.Size() == OutputTexture->Desc.Extent;
+
+	FCBRSpatialUpscalePS::FParameters* PassParameters = GraphBuilder.AllocParameters<FCBRSpatialUpscalePS::FParameters>();
+	PassParameters->InputTexture = InputTexture;
+	PassParameters->InputViewRect = FVector4(View.ViewRect.Min.X, View.ViewRect.Min.Y, View.ViewRect.Width(), View.ViewRect.Height());
+	PassParameters->OutputViewRect = FVector4(OutputRect.Min.X, OutputRect.Min.Y, OutputRect.Width(), OutputRect.Height());
+	PassParameters->RenderTargets[0] = FRenderTargetBinding(OutputTexture, bCoversOutput ? ERenderTargetLoadAction::ENoAction : ERenderTargetLoadAction::ELoad);
+
+	FPixelShaderUtils::AddFullscreenPass(
+		GraphBuilder,
+		View.ShaderMap,
+		RDG_EVENT_NAME("CBRSpatialUpscale %dx%d -> %dx%d", View.ViewRect.Width(), View.ViewRect.Height(), OutputRect.Width(), OutputRect.Height()),
+		PixelShader,
+		PassParameters,
+		OutputRect);
+}
+
+//Object motion
+void FMobileSceneRenderer::CBRRenderVelocities(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, TRefCountPtr<IPooledRenderTarget>& SceneDepth)
+{
+	check(RHICmdList.IsOutsideRenderPass());
+
+	//只画移动物体: 速度pass对静止物体不出draw, 其余sample保持清成0, 重建时走相机重投影
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	FRDGTextureRef DepthTexture = GraphBuilder.RegisterExternalTexture(SceneDepth, TEXT("CBRSceneDepth"), ERenderTargetTexture::Targetable);
+	FRDGTextureRef VelocityTexture = GraphBuilder.RegisterExternalTexture(CBRVelocity, TEXT("CBRVelocity"), ERenderTargetTexture::Targetable);
+
+	AddClearRenderTargetPass(GraphBuilder, VelocityTexture);
+	RenderVelocities(GraphBuilder, DepthTexture, VelocityTexture, FSceneTextureShaderParameters(), EVelocityPass::Opaque, false);
+
+	GraphBuilder.Execute();
+}
+
+//Separate translucency
+class FCBRTranslucencyDownsampleColorPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRTranslucencyDownsampleColorPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRTranslucencyDownsampleColorPS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, SceneColorTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
+		SHADER_PARAMETER(uint32, CBRPixelsPerTexel)
+		SHADER_PARAMETER(FVector2D, InvBufferSize)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRTranslucencyDownsampleColorPS, TEXT("/Engine/Private/CBR/CBRSeparateTranslucency.usf"), TEXT("DownsampleColorPS"), SF_Pixel);
+
+class FCBRTranslucencyDownsampleDepthPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRTranslucencyDownsampleDepthPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRTranslucencyDownsampleDepthPS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, CBRSceneDepth)
+		SHADER_PARAMETER(uint32, CBRPixelsPerTexel)
+		SHADER_PARAMETER_TEXTURE(Texture2D, BackgroundTexture)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRTranslucencyDownsampleDepthPS, TEXT("/Engine/Private/CBR/CBRSeparateTranslucency.usf"), TEXT("DownsampleDepthPS"), SF_Pixel);
+
+class FCBRTranslucencyCompositePS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRTranslucencyCompositePS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRTranslucencyCompositePS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, TranslucencyTexture)
+		SHADER_PARAMETER_TEXTURE(Texture2D, BackgroundTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, TranslucencySampler)
+		SHADER_PARAMETER(FVector2D, InvBufferSize)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRTranslucencyCompositePS, TEXT("/Engine/Private/CBR/CBRSeparateTranslucency.usf"), TEXT("CompositePS"), SF_Pixel);
+
+void FMobileSceneRenderer::CBRRenderSeparateTranslucency(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const TArrayView<const FViewInfo*> ViewList, TRefCountPtr<IPooledRenderTarget>& SceneDepth, FRHITexture* SceneColorTarget, int32 Factor)
+{
+	check(RHICmdList.IsOutsideRenderPass());
+	SCOPED_DRAW_EVENT(RHICmdList, CBRSeparateTranslucency);
+
+	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
+	const FIntPoint BufferSize = SceneContext.GetBufferSizeXY();
+	const FIntPoint TranslucencySize = FIntPoint::DivideAndRoundUp(BufferSize, Factor);
+
+	const FPooledRenderTargetDesc DescT = FPooledRenderTargetDesc::Create2DDesc(TranslucencySize, PF_FloatRGBA, FClearValueBinding(FLinearColor(0, 0, 0, 1)), TexCreate_None, TexCreate_RenderTargetable | TexCreate_ShaderResource, false);
+	FPooledRenderTargetDesc DescTD = FPooledRenderTargetDesc::Create2DDesc(TranslucencySize, PF_DepthStencil, FClearValueBinding::DepthFar, TexCreate_None, TexCreate_DepthStencilTargetable, false);
+	DescTD.TargetableFlags |= TexCreate_Memoryless;
+	GRenderTargetPool.FindFreeElement(RHICmdList, DescT, CBRTranslucencyColor, TEXT("CBRTranslucencyColor"));
+	GRenderTargetPool.FindFreeElement(RHICmdList, DescT, CBRTranslucencyBackground, TEXT("CBRTranslucencyBackground"));
+	GRenderTargetPool.FindFreeElement(RHICmdList, DescTD, CBRTranslucencyDepth, TEXT("CBRTranslucencyDepth"));
+
+	FRHITexture* CBRDepth = SceneDepth->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* TranslucencyColor = CBRTranslucencyColor->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* TranslucencyBackground = CBRTranslucencyBackground->GetRenderTargetItem().TargetableTexture;
+	FRHITexture* TranslucencyDepth = CBRTranslucencyDepth->GetRenderTargetItem().TargetableTexture;
+	const FIntRect TranslucencyRect(View.ViewRect.Min / Factor, FIntPoint::DivideAndRoundUp(View.ViewRect.Max, Factor));
+	const FVector2D InvBufferSize(1.0f / BufferSize.X, 1.0f / BufferSize.Y);
+
+	FRHITransitionInfo TransitionsBackground[] = {
+		FRHITransitionInfo(SceneColorTarget, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(TranslucencyBackground, ERHIAccess::Unknown, ERHIAccess::RTV)
+	};
+	RHICmdList.Transition(MakeArrayView(TransitionsBackground, UE_ARRAY_COUNT(TransitionsBackground)));
+
+	//混合状态只写rgb, 没有透射率: 先把降采样的场景颜色存一份, 合成时只加上半透明带来的差值
+	FRHIRenderPassInfo BackgroundRPInfo(TranslucencyBackground, ERenderTargetActions::Clear_Store);
+	RHICmdList.BeginRenderPass(BackgroundRPInfo, TEXT("CBRTranslucencyBackground"));
+	{
+		TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+		TShaderMapRef<FCBRTranslucencyDownsampleColorPS> PixelShader(View.ShaderMap);
+
+		FGraphicsPipelineStateInitializer GraphicsPSOInit;
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+		extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+		FCBRTranslucencyDownsampleColorPS::FParameters PassParameters;
+		PassParameters.SceneColorTexture = SceneColorTarget;
+		PassParameters.SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		PassParameters.CBRPixelsPerTexel = Factor / 2;
+		PassParameters.InvBufferSize = InvBufferSize;
+		SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+		RHICmdList.SetViewport(TranslucencyRect.Min.X, TranslucencyRect.Min.Y, 0.0f, TranslucencyRect.Max.X, TranslucencyRect.Max.Y, 1.0f);
+
+		const FIntPoint TargetSize = TranslucencyRect.Size();
+		DrawRectangle(
+			RHICmdList,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			TargetSize,
+			TargetSize,
+			VertexShader,
+			EDRF_UseTriangleOptimization);
+	}
+	RHICmdList.EndRenderPass();
+
+	FRHITransitionInfo TransitionsBefore[] = {
+		FRHITransitionInfo(CBRDepth, ERHIAccess::Unknown, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(TranslucencyBackground, ERHIAccess::RTV, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(TranslucencyColor, ERHIAccess::Unknown, ERHIAccess::RTV),
+		FRHITransitionInfo(TranslucencyDepth, ERHIAccess::Unknown, ERHIAccess::DSVWrite)
+	};
+	RHICmdList.Transition(MakeArrayView(TransitionsBefore, UE_ARRAY_COUNT(TransitionsBefore)));
+
+	//1. 降采样深度, 颜色从背景开始 2. 半/四分之一分辨率画半透明, 深度只读
+	FRHIRenderPassInfo RPInfo(
+		TranslucencyColor,
+		ERenderTargetActions::Clear_Store,
+		nullptr,
+		TranslucencyDepth,
+		EDepthStencilTargetActions::ClearDepthStencil_DontStoreDepthStencil,
+		nullptr,
+		FExclusiveDepthStencil::DepthWrite_StencilWrite
+	);
+	RPInfo.SubpassHint = ESubpassHint::DepthReadSubpass;
+	RHICmdList.BeginRenderPass(RPInfo, TEXT("CBRSeparateTranslucency"));
+	{
+		TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+		TShaderMapRef<FCBRTranslucencyDownsampleDepthPS> PixelShader(View.ShaderMap);
+
+		FGraphicsPipelineStateInitializer GraphicsPSOInit;
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<true, CF_Always>::GetRHI();
+
+		extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+		FCBRTranslucencyDownsampleDepthPS::FParameters PassParameters;
+		PassParameters.CBRSceneDepth = CBRDepth;
+		// The CBR targets are half resolution on each axis
+		PassParameters.CBRPixelsPerTexel = Factor / 2;
+		PassParameters.BackgroundTexture = TranslucencyBackground;
+		SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+		RHICmdList.SetViewport(TranslucencyRect.Min.X, TranslucencyRect.Min.Y, 0.0f, TranslucencyRect.Max.X, TranslucencyRect.Max.Y, 1.0f);
+
+		const FIntPoint TargetSize = TranslucencyRect.Size();
+		DrawRectangle(
+			RHICmdList,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			TargetSize,
+			TargetSize,
+			VertexShader,
+			EDRF_UseTriangleOptimization);
+	}
+
+	// Translucency can fetch depth like in the scene pass
+	RHICmdList.NextSubpass();
+	//视口按半透明target的缩放, 不加抖动
+	RenderTranslucency(RHICmdList, ViewList, Factor);
+	RHICmdList.EndRenderPass();
+
+	FRHITransitionInfo TransitionsComposite[] = {
+		FRHITransitionInfo(TranslucencyColor, ERHIAccess::RTV, ERHIAccess::SRVGraphics),
+		FRHITransitionInfo(SceneColorTarget, ERHIAccess::SRVGraphics, ERHIAccess::RTV)
+	};
+	RHICmdList.Transition(MakeArrayView(TransitionsComposite, UE_ARRAY_COUNT(TransitionsComposite)));
+
+	// Upsample and add the change translucency made to the background
+	FRHIRenderPassInfo CompositeRPInfo(SceneColorTarget, ERenderTargetActions::Load_Store);
+	RHICmdList.BeginRenderPass(CompositeRPInfo, TEXT("CBRTranslucencyComposite"));
+	{
+		TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+		TShaderMapRef<FCBRTranslucencyCompositePS> PixelShader(View.ShaderMap);
+
+		FGraphicsPipelineStateInitializer GraphicsPSOInit;
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.BlendState = TStaticBlendState<CW_RGB, BO_Add, BF_One, BF_One>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+		extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+		FCBRTranslucencyCompositePS::FParameters PassParameters;
+		PassParameters.TranslucencyTexture = TranslucencyColor;
+		PassParameters.BackgroundTexture = TranslucencyBackground;
+		PassParameters.TranslucencySampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		PassParameters.InvBufferSize = InvBufferSize;
+		SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+		RHICmdList.SetViewport(View.ViewRect.Min.X, View.ViewRect.Min.Y, 0.0f, View.ViewRect.Max.X, View.ViewRect.Max.Y, 1.0f);
+
+		const FIntPoint TargetSize = View.ViewRect.Size();
+		DrawRectangle(
+			RHICmdList,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			0, 0,
+			TargetSize.X, TargetSize.Y,
+			TargetSize,
+			TargetSize,
+			VertexShader,
+			EDRF_UseTriangleOptimization);
+	}
+	RHICmdList.EndRenderPass();
+	RHICmdList.Transition(FRHITransitionInfo(SceneColorTarget, ERHIAccess::RTV, ERHIAccess::SRVMask));
+}
+
+//Pixel projected reflection
+class FCBRPixelProjectedReflectionCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRPixelProjectedReflectionCS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRPixelProjectedReflectionCS, FGlobalShader);
+
+public:
+	static const FIntPoint TexelsPerThreadGroup;
+
+	static const uint32 ThreadGroupSizeX = 8;
+	static const uint32 ThreadGroupSizeY = 8;
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, CurrentDepth)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<uint>, OutputProjectionBuffer)
+		SHADER_PARAMETER(uint32, CurrentPhase)
+		SHADER_PARAMETER(FIntVector4, ViewRect)
+		SHADER_PARAMETER(FMatrix, InvViewProj)
+		SHADER_PARAMETER(FMatrix, ViewProj)
+		SHADER_PARAMETER(FVector4, ReflectionPlane)
+		SHADER_PARAMETER(FVector, PlaneNormalVanishingPoint)
+	END_SHADER_PARAMETER_STRUCT()
+};
+const FIntPoint FCBRPixelProjectedReflectionCS::TexelsPerThreadGroup(ThreadGroupSizeX, ThreadGroupSizeY);
+
+IMPLEMENT_SHADER_TYPE(, FCBRPixelProjectedReflectionCS, TEXT("/Engine/Private/CBR/CBRPixelProjectedReflection.usf"), TEXT("ProjectionCS"), SF_Compute);
+
+class FCBRPixelProjectedReflectionPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRPixelProjectedReflectionPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRPixelProjectedReflectionPS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, CurrentColor)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, ProjectionBuffer)
+		SHADER_PARAMETER(uint32, CurrentPhase)
+		SHADER_PARAMETER(FVector, PlaneNormalVanishingPoint)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRPixelProjectedReflectionPS, TEXT("/Engine/Private/CBR/CBRPixelProjectedReflection.usf"), TEXT("ResolvePS"), SF_Pixel);
+
+void FMobileSceneRenderer::CBRRenderPixelProjectedReflection(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const FPlanarReflectionSceneProxy* PlanarReflectionSceneProxy)
+{
+	if (!PlanarReflectionSceneProxy || !GPixelProjectedReflectionMobileOutputs.PixelProjectedReflectionTexture.IsValid())
+	{
+		return;
+	}
+
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	//PPR会关掉MSAA, 只有quarter rate能走到这里: 只读本帧slot的target
+	check(CBRData::bQuarterRate);
+	FRDGTextureRef CurrentColor = GraphBuilder.RegisterExternalTexture(CBRQuarterColorRefs[CBRData::mFrameOffset], TEXT("CBRSceneColor"), ERenderTargetTexture::Targetable);
+	FRDGTextureRef CurrentDepth = GraphBuilder.RegisterExternalTexture(CBRQuarterDepthRefs[CBRData::mFrameOffset], TEXT("CBRSceneDepth"), ERenderTargetTexture::Targetable);
+	FRDGTextureRef ReflectionTexture = GraphBuilder.RegisterExternalTexture(GPixelProjectedReflectionMobileOutputs.PixelProjectedReflectionTexture, TEXT("PixelProjectedReflectionTexture"));
+
+	FRDGTextureRef ProjectionBuffer = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2DDesc(
+		ReflectionTexture->Desc.Extent,
+		PF_R32_UINT,
+		FClearValueBinding::Black,
+		TexCreate_None,
+		TexCreate_ShaderResource | TexCreate_UAV,
+		false),
+		TEXT("CBRPixelProjectedReflectionBuffer"));
+	FRDGTextureUAVRef ProjectionBufferUAV = GraphBuilder.CreateUAV(ProjectionBuffer);
+	const uint32 ClearValues[4] = { 0, 0, 0, 0 };
+	AddClearUAVPass(GraphBuilder, ProjectionBufferUAV, ClearValues);
+
+	const uint32 CurrentPhase = uint32(CBRData::QuarterRateQuadrants[CBRData::mFrameOffset]);
+
+	//平面法线的消失点(像素坐标, 齐次): 像素, 它的反射和这个点在同一条屏幕直线上, 投影和resolve都按沿这条线的距离编码
+	const FVector4 NormalClip = View.ViewMatrices.GetViewProjectionMatrix().TransformFVector4(FVector4(PlanarReflectionSceneProxy->ReflectionPlane, 0.f));
+	const FVector PlaneNormalVanishingPoint(
+		(NormalClip.X * .5f + NormalClip.W * .5f) * View.ViewRect.Width() + View.ViewRect.Min.X * NormalClip.W,
+		(NormalClip.Y * -.5f + NormalClip.W * .5f) * View.ViewRect.Height() + View.ViewRect.Min.Y * NormalClip.W,
+		NormalClip.W);
+
+	{
+		TShaderMapRef<FCBRPixelProjectedReflectionCS> ComputeShader(View.ShaderMap);
+
+		FCBRPixelProjectedReflectionCS::FParameters* CSShaderParameters = GraphBuilder.AllocParameters<FCBRPixelProjectedReflectionCS::FParameters>();
+		CSShaderParameters->CurrentDepth = CurrentDepth;
+		CSShaderParameters->OutputProjectionBuffer = ProjectionBufferUAV;
+		CSShaderParameters->CurrentPhase = CurrentPhase;
+		CSShaderParameters->ViewRect = FIntVector4(View.ViewRect.Min.X, View.ViewRect.Min.Y, View.ViewRect.Width(), View.ViewRect.Height());
+		CSShaderParameters->InvViewProj = View.ViewMatrices.GetInvViewProjectionMatrix();
+		CSShaderParameters->ViewProj = View.ViewMatrices.GetViewProjectionMatrix();
+		CSShaderParameters->ReflectionPlane = FVector4(PlanarReflectionSceneProxy->ReflectionPlane, PlanarReflectionSceneProxy->ReflectionPlane.W);
+		CSShaderParameters->PlaneNormalVanishingPoint = PlaneNormalVanishingPoint;
+
+		//每个线程处理本帧slot的一个像素
+		FComputeShaderUtils::AddPass(
+			GraphBuilder,
+			RDG_EVENT_NAME("CBRPixelProjectedReflection(Projection)"),
+			ERDGPassFlags::Compute,
+			ComputeShader,
+			CSShaderParameters,
+			FComputeShaderUtils::GetGroupCount(CurrentDepth->Desc.Extent, FCBRPixelProjectedReflectionCS::TexelsPerThreadGroup)
+		);
+	}
+
+	{
+		TShaderMapRef<FCBRPixelProjectedReflectionPS> PixelShader(View.ShaderMap);
+
+		FCBRPixelProjectedReflectionPS::FParameters* PassParameters = GraphBuilder.AllocParameters<FCBRPixelProjectedReflectionPS::FParameters>();
+		PassParameters->CurrentColor = CurrentColor;
+		PassParameters->ProjectionBuffer = ProjectionBuffer;
+		PassParameters->CurrentPhase = CurrentPhase;
+		PassParameters->PlaneNormalVanishingPoint = PlaneNormalVanishingPoint;
+		PassParameters->RenderTargets[0] = FRenderTargetBinding(ReflectionTexture, ERenderTargetLoadAction::ENoAction);
+
+		FPixelShaderUtils::AddFullscreenPass(
+			GraphBuilder,
+			View.ShaderMap,
+			RDG_EVENT_NAME("CBRPixelProjectedReflection(Resolve) %dx%d", View.ViewRect.Width(), View.ViewRect.Height()),
+			PixelShader,
+			PassParameters,
+			View.ViewRect);
+	}
+
+	GraphBuilder.Execute();
+}
+
+//Full depth prepass
+void FMobileSceneRenderer::CBRRenderFullPrepass(FRHICommandListImmediate& RHICmdList, FRHITexture* CBRSceneDepth)
+{
+	check(CBRData::bQuarterRate);
+
+	FRHIRenderPassInfo DepthPrePassRenderPassInfo(
+		CBRSceneDepth,
+		EDepthStencilTargetActions::ClearDepthStencil_StoreDepthStencil);
+
+	DepthPrePassRenderPassInfo.NumOcclusionQueries = ComputeNumOcclusionQueriesToBatch();
+	DepthPrePassRenderPassInfo.bOcclusionQueries = DepthPrePassRenderPassInfo.NumOcclusionQueries != 0;
+
+	RHICmdList.BeginRenderPass(DepthPrePassRenderPassInfo, TEXT("CBRDepthPrepass"));
+
+	RHICmdList.SetCurrentStat(GET_STATID(STAT_CLM_MobilePrePass));
+	RenderPrePass(RHICmdList);
+
+	// Issue occlusion queries
+	RHICmdList.SetCurrentStat(GET_STATID(STAT_CLMM_Occlusion));
+	RenderOcclusion(RHICmdList);
+
+	RHICmdList.EndRenderPass();
+}
+
+//Compact depth history
+class FCBRExportDepthPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRExportDepthPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRExportDepthPS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_SHADER_TYPE(, FCBRExportDepthPS, TEXT("/Engine/Private/CBR/CBRExportDepth.usf"), TEXT("MainPS"), SF_Pixel);
+
+void FMobileSceneRenderer::CBRExportDepthHistory(FRHICommandListImmediate& RHICmdList, const FViewInfo& View)
+{
+	// Part of scene rendering pass, depth is read only and can be fetched
+	check(RHICmdList.IsInsideRenderPass());
+	SCOPED_DRAW_EVENT(RHICmdList, CBRExportDepthHistory);
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+	// Only MRT1 (the depth history) is written
+	GraphicsPSOInit.BlendState = TStaticBlendState<CW_NONE, BO_Add, BF_One, BF_Zero, BO_Add, BF_One, BF_Zero, CW_RED>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+	TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+	TShaderMapRef<FCBRExportDepthPS> PixelShader(View.ShaderMap);
+
+	extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+	GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+	GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+	GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+	FCBRExportDepthPS::FParameters PassParameters;
+	PassParameters.View = View.ViewUniformBuffer;
+	SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+	CBRData::SetViewport(RHICmdList, View.ViewRect);
+
+	const FIntPoint TargetSize = View.ViewRect.Size();
+	DrawRectangle(
+		RHICmdList,
+		0, 0,
+		TargetSize.X, TargetSize.Y,
+		0, 0,
+		TargetSize.X, TargetSize.Y,
+		TargetSize,
+		TargetSize,
+		VertexShader,
+		EDRF_UseTriangleOptimization);
+}
+
+//Split samples
+class FCBRSplitSamplesPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FCBRSplitSamplesPS, Global);
+	SHADER_USE_PARAMETER_STRUCT(FCBRSplitSamplesPS, FGlobalShader);
+
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsMobilePlatform(Parameters.Platform);
+	}
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+		SHADER_PARAMETER_UAV(RWTexture2D<uint>, SplitOutput)
+	END_SHADER_PARAMETER_STRUCT()
 };
 
+IMPLEMENT_SHADER_TYPE(, FCBRSplitSamplesPS, TEXT("/Engine/Private/CBR/CBRSplitSamples.usf"), TEXT("MainPS"), SF_Pixel);
+
+void FMobileSceneRenderer::CBRSplitSamples(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, FRHIUnorderedAccessView* SplitOutputUAV)
+{
+	// Part of scene rendering pass, the colour samples are read through framebuffer fetch
+	check(RHICmdList.IsInsideRenderPass());
+	SCOPED_DRAW_EVENT(RHICmdList, CBRSplitSamples);
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+	GraphicsPSOInit.BlendState = TStaticBlendState<CW_NONE, BO_Add, BF_One, BF_Zero, BO_Add, BF_One, BF_Zero, CW_NONE>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+	TShaderMapRef<FScreenVS> VertexShader(View.ShaderMap);
+	TShaderMapRef<FCBRSplitSamplesPS> PixelShader(View.ShaderMap);
+
+	extern TGlobalResource<FFilterVertexDeclaration> GFilterVertexDeclaration;
+	GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+	GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+	GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+	FCBRSplitSamplesPS::FParameters PassParameters;
+	PassParameters.View = View.ViewUniformBuffer;
+	PassParameters.SplitOutput = SplitOutputUAV;
+	SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PassParameters);
+
+	CBRData::SetViewport(RHICmdList, View.ViewRect);
+
+	const FIntPoint TargetSize = View.ViewRect.Size();
+	DrawRectangle(
+		RHICmdList,
+		0, 0,
+		TargetSize.X, TargetSize.Y,
+		0, 0,
+		TargetSize.X, TargetSize.Y,
+		TargetSize,
+		TargetSize,
+		VertexShader,
+		EDRF_UseTriangleOptimization);
+}
 
 //Depth Resolve
 class FCBRReconstructDepthCS : public FGlobalShader
@@ -31,7 +31,7 @@
 #include "MeshPassProcessor.inl"
 #include "ClearQuad.h"
 
-void FMobileSceneRenderer::RenderTranslucency(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> PassViews)
+void FMobileSceneRenderer::RenderTranslucency(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> PassViews, int32 CBRTranslucencyFactor)
 {
 	ETranslucencyPass::Type TranslucencyPass = 
 		ViewFamily.AllowTranslucencyAfterDOF() ? ETranslucencyPass::TPT_StandardTranslucency : ETranslucencyPass::TPT_AllTranslucency;
@@ -51,12 +51,14 @@ void FMobileSceneRenderer::RenderTranslucency(FRHICommandListImmediate& RHICmdLi
 				continue;
 			}
 			//CBR Code
-			RHICmdList.SetViewport(View.ViewRect.Min.X / CBRData::mDownsizeFactor.X + CBRData::mFrameOffset * (CBRData::bCBR ? .5f : 0.f)
-				, View.ViewRect.Min.Y / CBRData::mDownsizeFactor.Y
-				, 0
-				, View.ViewRect.Max.X / CBRData::mDownsizeFactor.X + CBRData::mFrameOffset * (CBRData::bCBR ? .5f : 0.f)
-				, View.ViewRect.Max.Y / CBRData::mDownsizeFactor.Y
-				, 1);
+			if (CBRTranslucencyFactor > 0)
+			{
+				CBRData::SetViewport(RHICmdList, View.ViewRect, FVector2D(CBRTranslucencyFactor, CBRTranslucencyFactor), FVector2D::ZeroVector);
+			}
+			else
+			{
+				CBRData::SetViewport(RHICmdList, View.ViewRect);
+			}
 			//
 			if (!View.Family->UseDebugViewPS())
 			{
@@ -69,6 +69,17 @@ static TAutoConsoleVariable<bool> CVarMobileEnableOcclusionExtraFrame(
 	ECVF_RenderThreadSafe
 	);
 
+//CBR Code
+static TAutoConsoleVariable<int32> CVarMobileCBRPhaseOcclusion(
+	TEXT("r.Mobile.CBR.PhaseOcclusion"),
+	1,
+	TEXT("Occlusion proxies are tested against the checkerboard depth of one phase only, so thin objects can flip between visible and occluded every frame.\n")
+	TEXT("While CBR is on, a shadow is only treated as occluded when the results of both phases agree. Primitive occlusion does not combine phases yet.\n")
+	TEXT(" 0: Disable\n")
+	TEXT(" 1: Enabled (Default)"),
+	ECVF_Scalability | ECVF_RenderThreadSafe);
+//
+
 DEFINE_GPU_STAT(HZB);
 
 /** Random table for occlusion **/
@@ -264,6 +275,22 @@ bool FSceneViewState::IsShadowOccluded(FRHICommandListImmediate& RHICmdList, FSc
 
 	if (Query && RHICmdList.GetRenderQueryResult(Query->GetQuery(), NumSamples, bWaitOnQuery))
 	{
+		//CBR Code
+		// The oldest query was drawn in one checkerboard phase, the query issued one frame later in the other one.
+		// Only trust "occluded" when both agree; a missing or pending second result keeps the single phase answer.
+		// Shadows are set up before CBR is decided for this frame, so bCBR is still the state the pending queries were drawn with.
+		if (NumSamples == 0 && CBRData::bCBR && CVarMobileCBRPhaseOcclusion.GetValueOnRenderThread() != 0 && NumBufferedFrames > 1)
+		{
+			const uint32 OtherPhaseQueryIndex = FOcclusionQueryHelpers::GetQueryLookupIndex(PendingPrevFrameNumber + 1, NumBufferedFrames);
+			const FRHIPooledRenderQuery* OtherPhaseQuery = ShadowOcclusionQueryMaps[OtherPhaseQueryIndex].Find(ShadowKey);
+			uint64 OtherPhaseNumSamples = 0;
+			if (OtherPhaseQuery && RHICmdList.GetRenderQueryResult(OtherPhaseQuery->GetQuery(), OtherPhaseNumSamples, false))
+			{
+				NumSamples = OtherPhaseNumSamples;
+			}
+		}
+		//
+
 		// If the shadow's occlusion query didn't have any pixels visible the previous frame, it's occluded.
 		return NumSamples == 0;
 	}
@@ -1295,12 +1322,7 @@ static void BeginOcclusionTests(
 
 		const FIntRect ViewRect = GetDownscaledRect(View.ViewRect, DownsampleFactor); 
 		//CBR Code
-		RHICmdList.SetViewport(ViewRect.Min.X / CBRData::mDownsizeFactor.X + CBRData::mFrameOffset * (CBRData::bCBR ? .5f : 0.f)
-			, ViewRect.Min.Y / CBRData::mDownsizeFactor.Y
-			, 0
-			, ViewRect.Max.X / CBRData::mDownsizeFactor.X + CBRData::mFrameOffset * (CBRData::bCBR ? .5f : 0.f)
-			, ViewRect.Max.Y / CBRData::mDownsizeFactor.Y
-			, 1);//
+		CBRData::SetViewport(RHICmdList, ViewRect);//
 
 		// Lookup the vertex shader.
 		TShaderMapRef<FOcclusionQueryVS> VertexShader(View.ShaderMap);
@@ -1413,6 +1435,9 @@ void FDeferredShadingSceneRenderer::RenderOcclusion(
 	TRDGUniformBufferRef<FSceneTextureUniformParameters> SceneTexturesUniformBuffer,
 	bool bIsOcclusionTesting)
 {
+	//CBR Code 桌面延迟管线没有棋盘渲染, 不能沿用移动端上一帧留下的CBR视口
+	CBRData::SetFullResolution();
+
 	if (bIsOcclusionTesting)
 	{
 		check(SceneDepthTexture);
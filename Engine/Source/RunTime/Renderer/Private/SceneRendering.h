@@ -1686,7 +1686,72 @@ struct CBRData {
 	static FVector2D mDownsizeFactor;
 	static uint32 FrameCount;
 	static int32 mFrameOffset;
+	/** The RHI can sample the CBR targets but cannot shade them per sample, so only the current frame is used for reconstruction. */
+	static bool bSpatialOnly;
+	/** 4 frame cycle: every frame shades one quadrant of each 2x2 block into a single sample target, mFrameOffset is the slot 0..3. */
+	static bool bQuarterRate;
+	/** Quadrant (x + 2y) shaded by each quarter rate slot, diagonal pairs first so two consecutive frames form a checkerboard. */
+	static const int32 QuarterRateQuadrants[4];
+	/** Sub pixel offset of the current frame inside the downsized target, in downsized pixels. */
+	static FVector2D mViewportOffset;
+
+	/**
+	 * Everything a view carries from one CBR frame to the next. Every view state (main view, scene capture, planar reflection)
+	 * has its own, so views never share a checkerboard phase, reprojection matrices or history targets.
+	 */
+	struct FViewHistory
+	{
+		/** Frames of the cycle rendered by this view, FrameCount is loaded from and stored back to it. */
+		uint32 FrameCount = 0;
+		/** GFrameNumberRenderThread of the last frame the view was rendered. */
+		uint32 LastFrameNumber = 0;
+		FMatrix PrevInvViewProj;
+		FMatrix PrevPrevInvViewProj;
+		FMatrix RightEyePrevInvViewProj;
+		FMatrix HistoryInvViewProj[4];
+		/** View of the last frame interpolated from, only valid once bHasInterpolateViewMatrices is set. */
+		FViewMatrices InterpolateViewMatrices;
+		bool bHasInterpolateViewMatrices = false;
+		/** History targets in allocation order, kept referenced so the pool never hands them to another view. */
+		TArray<TRefCountPtr<IPooledRenderTarget>> Targets;
+		int32 NextTarget = 0;
+
+		/** Same as GRenderTargetPool.FindFreeElement, but returns the target this view got at the same point last frame when the desc still matches. */
+		void FindTarget(FRHICommandList& RHICmdList, const FPooledRenderTargetDesc& Desc, TRefCountPtr<IPooledRenderTarget>& Out, const TCHAR* Name);
+
+		/** Points every history matrix at the current frame, for views that start a new history. */
+		void ResetMatrices(const FMatrix& InvViewProj);
+	};
+
+	/**
+	 * Returns the history of the view, nullptr for views without a view state (one-shot scene captures).
+	 * bOutHistoryValid is false when there is nothing usable to reproject from, the view must then reconstruct spatially only.
+	 */
+	static FViewHistory* BeginView(const FViewInfo& View, bool& bOutHistoryValid);
+
+	/** Releases the histories of views that have not rendered CBR for a while. Runs every frame, also for views that render without CBR. */
+	static void ReleaseStaleHistories();
+
+	/** Releases every history: when CBR is turned off and when the RHI resources are released. */
+	static void ReleaseHistories();
+
+	/** Starts a new frame of the cycle: picks mFrameOffset and the sub pixel viewport offset of its phase or quarter rate slot. */
+	static void AdvanceFrame(FViewHistory* History);
+
+	/** Renderers without a checkerboard path call this so the passes they share with CBR (occlusion tests) use the full resolution view rect. */
+	static void SetFullResolution();
+
+	/** Whether the RHI behind this shader platform can render to and sample 2x MSAA targets (GLES, Vulkan). */
+	static bool SupportsPlatform(EShaderPlatform Platform);
+
+	/** Sets the viewport of a full resolution rect inside the checkerboard target of the current frame. */
+	static void SetViewport(FRHICommandList& RHICmdList, const FIntRect& ViewRect);
+
+	/** Same as above with an explicit downsize factor and sub pixel offset, for targets that are not the CBR scene target of this frame. */
+	static void SetViewport(FRHICommandList& RHICmdList, const FIntRect& ViewRect, const FVector2D& DownsizeFactor, const FVector2D& ViewportOffset);
 private:
+	static TMap<uint32, FViewHistory> ViewHistories;
+
 	CBRData() {};
 };
 //
@@ -2114,10 +2179,15 @@ BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FCBRUniformBuffer, )
 	SHADER_PARAMETER(uint32, FrameOffset)
 	SHADER_PARAMETER(float, DepthTolerance)
 	SHADER_PARAMETER(uint32, Flags)
-	SHADER_PARAMETER(float, _Pad)
+	SHADER_PARAMETER(float, SkyDeviceZ)
 	SHADER_PARAMETER(FVector4, LinearZTransform)
 	SHADER_PARAMETER(FMatrix, CurrViewProj)
 	SHADER_PARAMETER(FMatrix, PrevInvViewProj)
+	SHADER_PARAMETER(FVector4, InvDeviceZToWorldZTransform)
+	SHADER_PARAMETER_ARRAY(FMatrix, HistoryInvViewProj, [4])
+	SHADER_PARAMETER(FMatrix, PrevPrevInvViewProj)
+	SHADER_PARAMETER(FMatrix, RightEyeCurrViewProj)
+	SHADER_PARAMETER(FMatrix, RightEyePrevInvViewProj)
 END_GLOBAL_SHADER_PARAMETER_STRUCT()
 
 BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FCBRUniformBufferDepth, )
@@ -2192,19 +2262,51 @@ protected:
 	/** Renders decals. */
 	void RenderDecals(FRHICommandListImmediate& RHICmdList);
 
-	/** Renders the base pass for translucency. */
-	void RenderTranslucency(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> PassViews);
+	/** Renders the base pass for translucency. CBRTranslucencyFactor > 0 renders into the CBR separate translucency target downsized by that factor. */
+	void RenderTranslucency(FRHICommandListImmediate& RHICmdList, const TArrayView<const FViewInfo*> PassViews, int32 CBRTranslucencyFactor = 0);
 
 	/** Creates uniform buffers with the mobile directional light parameters, for each lighting channel. Called by InitViews */
 	void CreateDirectionalLightUniformBuffers(FViewInfo& View);
 
 	//CBR code
+	//History of the view being rendered, nullptr when it has no view state
+	CBRData::FViewHistory* CBRViewHistory = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBRSceneColorRef1 = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthRef1 = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBRSceneColorRef0 = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthRef0 = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBROutput = nullptr;
 	TRefCountPtr<IPooledRenderTarget> CBROutputDepth = nullptr;
+	//Frame interpolation: reconstructed outputs alternate so the previous frame is still available
+	TRefCountPtr<IPooledRenderTarget> CBROutputRef1 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBROutputRef0 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRInterpolatedOutput = nullptr;
+	//Compact depth history: depth stays in tile memory, only per-sample scene depth (R16F) is stored
+	TRefCountPtr<IPooledRenderTarget> CBRDepthHistoryRef1 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRDepthHistoryRef0 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthMemoryless = nullptr;
+	//Split samples: both colour samples packed side by side into a plain 2x wide R32_UINT texture
+	TRefCountPtr<IPooledRenderTarget> CBRSplitColorRef1 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSplitColorRef0 = nullptr;
+	//Quarter rate: one single sample colour/depth target per slot of the 4 frame cycle
+	TRefCountPtr<IPooledRenderTarget> CBRQuarterColorRefs[4];
+	TRefCountPtr<IPooledRenderTarget> CBRQuarterDepthRefs[4];
+	//Velocity of movable primitives for the current frame, same 2x MSAA layout as the CBR targets
+	TRefCountPtr<IPooledRenderTarget> CBRVelocity = nullptr;
+	//Second history: the other target of each phase, holds frame N-2 for the current phase after the per frame swap
+	TRefCountPtr<IPooledRenderTarget> CBRSceneColorN2Ref1 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthN2Ref1 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSceneColorN2Ref0 = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthN2Ref0 = nullptr;
+	//Separate translucency: single sample colour drawn over a copy of the downsampled background, and depth at half or quarter resolution
+	TRefCountPtr<IPooledRenderTarget> CBRTranslucencyColor = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRTranslucencyBackground = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRTranslucencyDepth = nullptr;
+	//Quarter rate GBuffer of the mobile deferred path, same flags as the scene GBuffer
+	TRefCountPtr<IPooledRenderTarget> CBRGBufferA = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRGBufferB = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRGBufferC = nullptr;
+	TRefCountPtr<IPooledRenderTarget> CBRSceneDepthAux = nullptr;
 
 	FCBRUniformBuffer CBRUniformBuffer;
 	FCBRUniformBufferDepth CBRUniformBufferDepth;
@@ -2216,6 +2318,17 @@ protected:
 		TRefCountPtr<IPooledRenderTarget> SceneDepthRef0;
 		TRefCountPtr<IPooledRenderTarget> SceneColorRef1;
 		TRefCountPtr<IPooledRenderTarget> SceneDepthRef1;
+		//SceneDepthRef0/1 hold scene depth from the compact history instead of device z
+		bool bCompactDepth = false;
+		//SceneColorRef0/1 are the packed split sample textures instead of the 2x MSAA targets
+		bool bSplitSamples = false;
+		//Optional velocity of the current frame, reconstruction falls back to camera reprojection without it
+		TRefCountPtr<IPooledRenderTarget> Velocity;
+		//Optional frame N-2, same checkerboard phase as the current frame
+		TRefCountPtr<IPooledRenderTarget> SceneColorRef2;
+		TRefCountPtr<IPooledRenderTarget> SceneDepthRef2;
+		//Mobile multiview: every target is an array with one layer per eye
+		bool bMultiView = false;
 
 		CBRInputs(TRefCountPtr<IPooledRenderTarget>& SceneColorRef,
 		TRefCountPtr<IPooledRenderTarget>& SceneDepthRef,
@@ -2239,8 +2352,24 @@ protected:
 		}
 	};
 
+	void CBRUpdateUniformBuffer(const FViewInfo& View);
 	void CBRReconstructPass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, TRefCountPtr<IPooledRenderTarget>& OutputTexture);
+	void CBRReconstructQuarterRatePass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, TRefCountPtr<IPooledRenderTarget>& OutputTexture);
+	void CBRInterpolatePass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, TRefCountPtr<IPooledRenderTarget>& CurrColor, TRefCountPtr<IPooledRenderTarget>& PrevColor, TRefCountPtr<IPooledRenderTarget>& OutputTexture);
 	void CBRReconstructDepthPass(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRDepthInputs& inputs, TRefCountPtr<IPooledRenderTarget>& OutputTexture);
+	void CBRReconstructPassPS(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const CBRInputs& inputs, FRHITexture* OutputTexture);
+	void CBRExportDepthHistory(FRHICommandListImmediate& RHICmdList, const FViewInfo& View);
+	void CBRSplitSamples(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, FRHIUnorderedAccessView* SplitOutputUAV);
+	void CBRRenderSeparateTranslucency(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const TArrayView<const FViewInfo*> ViewList, TRefCountPtr<IPooledRenderTarget>& SceneDepth, FRHITexture* SceneColorTarget, int32 Factor);
+	void CBRRenderVelocities(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, TRefCountPtr<IPooledRenderTarget>& SceneDepth);
+	//Decides whether the forward path renders this view with CBR, before anything (the full prepass) depends on it
+	void CBRInitForward(const FViewInfo& View);
+	//Full depth prepass (and occlusion) into the quarter rate depth target of the current slot, the CBR base pass loads it for early-Z
+	void CBRRenderFullPrepass(FRHICommandListImmediate& RHICmdList, FRHITexture* CBRSceneDepth);
+	//Pixel projected reflection from the samples of the current quarter rate slot only, replaces RenderPixelProjectedReflection under CBR
+	void CBRRenderPixelProjectedReflection(FRHICommandListImmediate& RHICmdList, const FViewInfo& View, const FPlanarReflectionSceneProxy* PlanarReflectionSceneProxy);
+	bool ShouldCBRSpatialUpscale() const;
+	void CBRSpatialUpscalePass(FRDGBuilder& GraphBuilder, const FViewInfo& View, FRDGTextureRef InputTexture, FRDGTextureRef OutputTexture);
 	//
 
 	/** On chip pre-tonemap before scene color MSAA resolve (iOS only) */